@@ -0,0 +1,1000 @@
+#pragma once
+
+#include "coordinator.h"
+#include "decode.h"
+#include "cache.h"
+#include "management_background.h"
+#include "management_character.h"
+#include "management_tile.h"
+#include "management_atlas.h"
+#include "management_gen.h"
+#include "managment_level.h"
+#include "task.h"
+#include "render_span.h"
+#include "render_tile.h"
+#include "render_strip.h"
+#include "render_scene.h"
+#include "render_indexed.h"
+#include "render_upscale.h"
+#include "encode.h"
+#include "prop_character.h"
+#include "prop_dir.h"
+
+/*
+ * The procedures of this file measure the throughput of performance-critical
+ * procedures of this application. They are only compiled if the "BENCHMARK"
+ * macro is defined, for instance by passing "-DBENCHMARK" to the compiler.
+ * Every benchmark writes its results to the benchmark log, since the debug
+ * console only holds its latest few messages. The latest results are still
+ * printed on the debug console, which Ctrl + C toggles on.
+ */
+
+#ifdef BENCHMARK
+
+#define BENCHMARK_DECODE_PIXELS (BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT)
+#define BENCHMARK_DECODE_ITERATIONS 64
+// The image decoded concurrently spans as many backgrounds as the value
+// below, such that it is split among every worker.
+#define BENCHMARK_SCALING_PIXELS (BENCHMARK_DECODE_PIXELS * 16)
+#define BENCHMARK_SCALING_ITERATIONS 8
+#define BENCHMARK_RUN_LENGTH_ITERATIONS 256
+#define BENCHMARK_RENDER_ITERATIONS 256
+// Rendering by testing every pixel is benchmarked alongside the blitters of
+// opaque spans, as the blitter below.
+#define BENCHMARK_BLIT_TESTED BLIT_VARIETY
+#define BENCHMARK_BLIT_VARIETY (BLIT_VARIETY + 1)
+// The tile strip is benchmarked by scrolling the camera over the level as
+// many times as the value below.
+#define BENCHMARK_STRIP_ITERATIONS 4
+#define BENCHMARK_SCENE_ITERATIONS 256
+// Banded rendering is benchmarked over rectangles as wide as the screen,
+// from as few rows as the value below up to the whole screen, doubling the
+// number of rows every time.
+#define BENCHMARK_BAND_MIN_ROWS (BACKBUFFER_HEIGHT / 8)
+#define BENCHMARK_EXPAND_ITERATIONS 256
+// The backbuffer is scaled up on windows of the heights below, whose width
+// is the one of a 16:9 screen.
+#define BENCHMARK_UPSCALE_HEIGHTS {1080, 1440, 2160}
+#define BENCHMARK_UPSCALE_ITERATIONS 16
+#define nameOf(character) #character
+
+// File that benchmark results are written to, which is opened on the first
+// result and closed once every benchmark ran.
+FILE* gpBenchmarkLog = NULL;
+
+__cdecl void benchmarkPrintf(const CHAR* restrict string, ...);
+
+__forceinline void closeBenchmarkLog();
+
+__forceinline void benchmarkDecode();
+
+__forceinline void benchmarkDecodeScaling();
+
+__forceinline void benchmarkAssetCache(
+    sPixel* const restrict pBackground,
+    const UINT32 backgroundPixels);
+
+__forceinline void benchmarkStartup(
+    sTask* const restrict pTasks,
+    const UINT8 tasks,
+    const UINT32 startupMicroseconds);
+
+__forceinline void benchmarkRunLength();
+
+__forceinline void benchmarkRunLengthAsset(
+    const CHAR* const restrict pName,
+    const UINT8 type,
+    const UINT8 id,
+    const CHAR* const restrict pDir,
+    const UINT32 imagePixels,
+    const UINT8 images);
+
+__forceinline void benchmarkRender();
+
+__forceinline UINT32 benchmarkRenderScene(
+    sPixel* const restrict pDestination,
+    const UINT8 blitter,
+    UINT32* const restrict pWrittenPixels);
+
+__forceinline UINT32 benchmarkRenderImage(
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const UINT8 blitter,
+    UINT32* const restrict pWrittenPixels);
+
+__forceinline void benchmarkTileStrip();
+
+__forceinline void renderTileViewport(
+    const UINT16 cameraLeftPosX,
+    const BOOLEAN isFromStrip);
+
+__forceinline void benchmarkRenderModes(
+    const sPixel* const restrict pBackground);
+
+__forceinline void benchmarkRenderMode(
+    const CHAR* const restrict pName,
+    const UINT16 cameraLeftPosX,
+    const sPixel* const restrict pBackground,
+    sPixel* const restrict pGolden);
+
+__forceinline void benchmarkRenderBands(
+    const sPixel* const restrict pBackground,
+    sPixel* const restrict pGolden);
+
+__forceinline void benchmarkExpand();
+
+__forceinline void benchmarkUpscale();
+
+__forceinline sScene buildBenchmarkScene(
+    const UINT16 cameraLeftPosX,
+    const sPixel* const restrict pBackground,
+    sSpriteDraw sprites[const static CHARACTER_VARIETY]);
+
+__forceinline UINT32 renderTestedPixels(
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    UINT32* const restrict pWrittenPixels);
+
+/*
+ * The "benchmarkPrintf" function writes a formatted line of results to the
+ * benchmark log, which is created by its first call, replacing the log of
+ * the previous run. The line is also printed on the debug console,
+ * truncated to the width of the console if needed. Results are only
+ * printed on the console if the log cannot be created.
+ */
+
+__cdecl void benchmarkPrintf(const CHAR* restrict string, ...) {
+
+    if (gpBenchmarkLog == NULL) {
+        gpBenchmarkLog = fopen(DIR_BENCHMARK_LOG, "w");
+    }
+    va_list args;
+    if (gpBenchmarkLog != NULL) {
+        va_start(args, string);
+        vfprintf(gpBenchmarkLog, string, args);
+        va_end(args);
+        fputc('\n', gpBenchmarkLog);
+    }
+    CHAR message[MAX_DEBUG_MESSAGE_SIZE];
+    va_start(args, string);
+    vsnprintf(message, sizeof(message), string, args);
+    va_end(args);
+    debugPrintf("%s", message);
+    return;
+}
+
+/*
+ * The "closeBenchmarkLog" function closes the benchmark log once every
+ * benchmark ran, and prints where the results were written on the debug
+ * console.
+ */
+
+__forceinline void closeBenchmarkLog() {
+
+    if (gpBenchmarkLog == NULL) {
+        return;
+    }
+    fclose(gpBenchmarkLog);
+    gpBenchmarkLog = NULL;
+    debugPrintf("Results in %s", DIR_BENCHMARK_LOG);
+    return;
+}
+
+/*
+ * The "benchmarkDecode" function decodes a background-sized image for every
+ * color code length featuring a vectorized kernel. Each length is decoded
+ * by the scalar kernels alone, then by the kernel that the processor
+ * supports. Both throughputs are printed in decoded megapixels per second.
+ */
+
+__forceinline void benchmarkDecode() {
+
+    const UINT32 encodedBytes = (BENCHMARK_DECODE_PIXELS
+        * DECODE_SIMD_MAX_CODE_BITS + 7) / 8;
+    BYTE* const pEncoded = malloc(encodedBytes);
+    sPixel* const pDecoded = malloc(BENCHMARK_DECODE_PIXELS
+        * sizeof(sPixel));
+    if (pEncoded == NULL || pDecoded == NULL) {
+        free(pEncoded);
+        free(pDecoded);
+        return;
+    }
+    BYTE palette[1 << DECODE_SIMD_MAX_CODE_BITS];
+    // A linear congruential generator fills the encoded pixel data such that
+    // every color code appears in an unpredictable order.
+    UINT32 seed = 0x1F2E3D4C;
+    for (UINT32 i = 0; i < encodedBytes; i++) {
+        seed = seed * 1664525 + 1013904223;
+        pEncoded[i] = seed >> 24;
+    }
+    for (UINT8 i = 0; i < sizeof(palette); i++) {
+        palette[i] = i * 17;
+    }
+
+    const UINT8 detectedSimdLevel = gSimdLevel;
+    UINT32 throughput[2];
+    UINT64 start;
+    for (UINT8 colorCodeBits = 1;
+            colorCodeBits <= DECODE_SIMD_MAX_CODE_BITS;
+            colorCodeBits++) {
+        for (UINT8 pass = 0; pass < 2; pass++) {
+            gSimdLevel = pass == 0 ? simdNone : detectedSimdLevel;
+            start = queryMicroseconds();
+            for (UINT8 i = 0; i < BENCHMARK_DECODE_ITERATIONS; i++) {
+                decodePixelDataFeaturing(
+                    1 << colorCodeBits,
+                    colorCodeBits,
+                    BENCHMARK_DECODE_PIXELS,
+                    (BENCHMARK_DECODE_PIXELS * colorCodeBits + 7) / 8,
+                    palette,
+                    pEncoded,
+                    pDecoded);
+            }
+            // Pixels per microsecond are megapixels per second.
+            throughput[pass] = (UINT64) BENCHMARK_DECODE_PIXELS
+                * BENCHMARK_DECODE_ITERATIONS
+                / (queryMicroseconds() - start + 1);
+        }
+        benchmarkPrintf("Decode %ib: %u/%u MP/s", colorCodeBits,
+            throughput[0], throughput[1]);
+    }
+    gSimdLevel = detectedSimdLevel;
+
+    free(pEncoded);
+    free(pDecoded);
+    return;
+}
+
+/*
+ * The "benchmarkDecodeScaling" function decodes a large image on 1, 2, 4
+ * and 8 workers, for several color code lengths. The speedup of every
+ * worker count against a single worker is printed in percent.
+ */
+
+__forceinline void benchmarkDecodeScaling() {
+
+    const UINT32 encodedBytes = BENCHMARK_SCALING_PIXELS;
+    BYTE* const pEncoded = malloc(encodedBytes);
+    sPixel* const pDecoded = malloc(BENCHMARK_SCALING_PIXELS
+        * sizeof(sPixel));
+    if (pEncoded == NULL || pDecoded == NULL) {
+        free(pEncoded);
+        free(pDecoded);
+        return;
+    }
+    // Encoded bytes never take the value 255, such that 8-bit codes index
+    // one of 255 colors, the most that a palette header can describe.
+    BYTE palette[255];
+    UINT32 seed = 0x1F2E3D4C;
+    for (UINT32 i = 0; i < encodedBytes; i++) {
+        seed = seed * 1664525 + 1013904223;
+        pEncoded[i] = (seed >> 24) % 255;
+    }
+    for (UINT8 i = 0; i < sizeof(palette); i++) {
+        palette[i] = i;
+    }
+
+    const UINT8 codeLengths[] = {1, 2, 3, 4, 8};
+    const UINT8 workers[] = {1, 2, 4, 8};
+    UINT32 elapsed[sizeof(workers)];
+    UINT8 colorCodeBits;
+    UINT64 start;
+    for (UINT8 i = 0; i < sizeof(codeLengths); i++) {
+        colorCodeBits = codeLengths[i];
+        for (UINT8 pass = 0; pass < sizeof(workers); pass++) {
+            start = queryMicroseconds();
+            for (UINT8 j = 0; j < BENCHMARK_SCALING_ITERATIONS; j++) {
+                decodePixelDataConcurrently(
+                    workers[pass],
+                    (1 << colorCodeBits) - (colorCodeBits == 8),
+                    colorCodeBits,
+                    BENCHMARK_SCALING_PIXELS,
+                    BENCHMARK_SCALING_PIXELS / 8 * colorCodeBits,
+                    palette,
+                    pEncoded,
+                    pDecoded);
+            }
+            elapsed[pass] = queryMicroseconds() - start + 1;
+        }
+        benchmarkPrintf("Scale %ib: 100/%u/%u/%u%%", colorCodeBits,
+            (UINT32) ((UINT64) 100 * elapsed[0] / elapsed[1]),
+            (UINT32) ((UINT64) 100 * elapsed[0] / elapsed[2]),
+            (UINT32) ((UINT64) 100 * elapsed[0] / elapsed[3]));
+    }
+
+    free(pEncoded);
+    free(pDecoded);
+    return;
+}
+
+/*
+ * The "benchmarkAssetCache" function times the graphic asset loaders with a
+ * cold, then a warm, decoded asset cache. All cache files are removed before
+ * the cold pass, which decodes every asset and writes its cache file. The
+ * warm pass reads every asset from the cache. Both durations are printed in
+ * microseconds, alongside the hits of the warm pass.
+ */
+
+__forceinline void benchmarkAssetCache(
+        sPixel* const restrict pBackground,
+        const UINT32 backgroundPixels) {
+
+    UINT32 elapsed[2];
+    UINT16 hits = 0;
+    UINT64 start;
+    for (UINT8 pass = 0; pass < 2; pass++) {
+        if (pass == 0) {
+            remove(DIR_CACHE_BACKGROUND);
+            remove(DIR_CACHE_TILE);
+        }
+        // The molds and the atlas loaded previously are replaced by the
+        // ones loaded below.
+        freeCharactersMolds();
+        hits = gDecodedCacheHits;
+        start = queryMicroseconds();
+        if (initBackground(pBackground, backgroundPixels) != ERROR_SUCCESS
+                || initCharacterMolds() != ERROR_SUCCESS
+                || initTilePixelData() != ERROR_SUCCESS
+                || buildAtlas() != ERROR_SUCCESS) {
+            return;
+        }
+        elapsed[pass] = queryMicroseconds() - start;
+        hits = gDecodedCacheHits - hits;
+    }
+    benchmarkPrintf("Cache cold: %u us", elapsed[0]);
+    benchmarkPrintf("Cache warm: %u us, %u hits", elapsed[1], hits);
+    return;
+}
+
+/*
+ * The "benchmarkStartup" function prints the duration of every task run at
+ * startup, and the wall-clock time of the whole startup. All tasks are then
+ * run again on a single worker, then on the pool of workers, to compare the
+ * wall-clock time of loading assets one after the other and concurrently.
+ * The atlas is built from the assets of every run.
+ */
+
+__forceinline void benchmarkStartup(
+        sTask* const restrict pTasks,
+        const UINT8 tasks,
+        const UINT32 startupMicroseconds) {
+
+    for (UINT8 i = 0; i < tasks; i++) {
+        benchmarkPrintf("%s: %u us", pTasks[i].pName, pTasks[i].microseconds);
+    }
+    benchmarkPrintf("Startup: %u us", startupMicroseconds);
+
+    const UINT8 workers[2] = {1, countTaskWorkers(tasks)};
+    UINT32 elapsed[2];
+    UINT64 start;
+    for (UINT8 pass = 0; pass < 2; pass++) {
+        // The memory allocated by the previous run of the tasks is
+        // replaced by the memory allocated below.
+        freeTilemap();
+        freeActors();
+        freeCharactersMolds();
+        start = queryMicroseconds();
+        if (runTasks(pTasks, tasks, workers[pass]) != ERROR_SUCCESS
+                || buildAtlas() != ERROR_SUCCESS) {
+            return;
+        }
+        elapsed[pass] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("Serial: %u us", elapsed[0]);
+    benchmarkPrintf("%u workers: %u us", workers[1], elapsed[1]);
+    return;
+}
+
+/*
+ * The "benchmarkRunLength" function compares the densely packed and the
+ * run-length coded formats on every shipped graphic asset. Each asset is
+ * coded in the latter format in memory. The sizes of both, in bytes, and
+ * the time to decode each one a fixed number of times, in microseconds,
+ * are printed. Molds must be initialized, since their dimensions are read.
+ */
+
+__forceinline void benchmarkRunLength() {
+
+    const CHAR* dirPixelData[] = generateCharacterArray(bitmapDirOf);
+    const CHAR* characterNames[] = generateCharacterArray(nameOf);
+    benchmarkRunLengthAsset("bck", ASSET_BACKGROUND, 0, DIR_BACKGROUND,
+        BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT, 1);
+    benchmarkRunLengthAsset("tile", ASSET_TILE, 0, DIR_TILE,
+        TILE_SIZE * TILE_SIZE, TILE_VARIETY);
+    for (UINT8 moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {
+        benchmarkRunLengthAsset(characterNames[moldId],
+            ASSET_CHARACTER_GRAPHIC, moldId, dirPixelData[moldId],
+            gCharacterMolds[moldId].collision.width
+            * gCharacterMolds[moldId].collision.height
+            * gCharacterMolds[moldId].frames, 1);
+    }
+    return;
+}
+
+/*
+ * The "benchmarkRunLengthAsset" function compares both formats on a single
+ * asset, which holds the passed number of images of the passed pixel count.
+ * Assets that are already run-length coded are not compared.
+ */
+
+__forceinline void benchmarkRunLengthAsset(
+        const CHAR* const restrict pName,
+        const UINT8 type,
+        const UINT8 id,
+        const CHAR* const restrict pDir,
+        const UINT32 imagePixels,
+        const UINT8 images) {
+
+    sMappedFile files[2];
+    if (mapAsset(type, id, pDir, &files[0]) != ERROR_SUCCESS) {
+        return;
+    }
+    BYTE* const pRunLength = malloc(images
+        * boundRunLengthImage(255, imagePixels));
+    sPixel* const pDecoded = malloc(imagePixels * sizeof(sPixel));
+    if (pRunLength == NULL || pDecoded == NULL) {
+        free(pRunLength);
+        free(pDecoded);
+        unmapFile(&files[0]);
+        return;
+    }
+
+    sEncodedImage image;
+    UINT32 sizes[2] = {0, 0};
+    for (UINT8 i = 0; i < images; i++) {
+        if (readImage(imagePixels, &files[0], &sizes[0], &image)
+                != ERROR_SUCCESS || image.isRunLength) {
+            free(pRunLength);
+            free(pDecoded);
+            unmapFile(&files[0]);
+            return;
+        }
+        sizes[1] += encodeRunLengthImage(image.colors, image.colorCodeBits,
+            imagePixels, image.pPalette, image.pEncodedPixelData,
+            pRunLength + sizes[1]);
+    }
+    // The run-length coded asset is read like a view into a mapping.
+    files[1] = (sMappedFile) {.pData = pRunLength, .size = sizes[1],
+        .isView = TRUE};
+
+    UINT32 elapsed[2];
+    UINT32 offset;
+    UINT64 start;
+    for (UINT8 format = 0; format < 2; format++) {
+        start = queryMicroseconds();
+        for (UINT16 j = 0; j < BENCHMARK_RUN_LENGTH_ITERATIONS; j++) {
+            offset = 0;
+            for (UINT8 i = 0; i < images; i++) {
+                readImage(imagePixels, &files[format], &offset, &image);
+                decodeImage(1, &image, imagePixels, pDecoded);
+            }
+        }
+        elapsed[format] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("%s %u/%uB %u/%uus", pName, sizes[0], sizes[1],
+        elapsed[0], elapsed[1]);
+
+    free(pRunLength);
+    free(pDecoded);
+    unmapFile(&files[0]);
+    return;
+}
+
+/*
+ * The "benchmarkRender" function compares rendering by testing every pixel
+ * against the transparent color with every way to render opaque spans that
+ * the processor supports. The rendered scene is the first screen of tiles
+ * of the level, and every frame of every mold in both orientations. The
+ * pixels tested by the former and the spans visited by the latter in a
+ * scene are printed, followed by the opaque pixels all of them write, and
+ * the time to render the scene a fixed number of times with each, in
+ * microseconds. Unsupported ways are timed as zero. Every way must render
+ * the same pixels as testing every pixel does, and those that do not are
+ * printed. Tiles, molds and the level must be initialized.
+ */
+
+__forceinline void benchmarkRender() {
+
+    const UINT32 backbufferPixels = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    sPixel* const pRendered = malloc(2 * backbufferPixels * sizeof(sPixel));
+    if (pRendered == NULL) {
+        return;
+    }
+    sPixel* const pGolden = pRendered + backbufferPixels;
+    UINT32 tests[BENCHMARK_BLIT_VARIETY];
+    UINT32 elapsed[BENCHMARK_BLIT_VARIETY] = {0};
+    UINT32 writtenPixels = 0;
+    UINT64 start;
+    // Testing every pixel is benchmarked first, since it renders the
+    // golden scene that the others are compared with.
+    for (UINT8 i = 0; i < BENCHMARK_BLIT_VARIETY; i++) {
+        const UINT8 blitter = (i + BENCHMARK_BLIT_TESTED)
+            % BENCHMARK_BLIT_VARIETY;
+        if (blitter != BENCHMARK_BLIT_TESTED && blitter > selectBlitter()) {
+            continue;
+        }
+        // The destination holds a pattern, such that pixels wrongly left
+        // unchanged or overwritten differ from the golden scene.
+        for (UINT32 j = 0; j < backbufferPixels; j++) {
+            pRendered[j].whole = j * 0x9E3779B1;
+        }
+        writtenPixels = 0;
+        tests[blitter] = benchmarkRenderScene(pRendered, blitter,
+            &writtenPixels);
+        if (blitter == BENCHMARK_BLIT_TESTED) {
+            memcpy(pGolden, pRendered, backbufferPixels * sizeof(sPixel));
+        } else if (memcmp(pRendered, pGolden,
+                backbufferPixels * sizeof(sPixel)) != 0) {
+            benchmarkPrintf("Blitter %u differs!", blitter);
+        }
+        start = queryMicroseconds();
+        for (UINT16 j = 0; j < BENCHMARK_RENDER_ITERATIONS; j++) {
+            benchmarkRenderScene(pRendered, blitter, &writtenPixels);
+        }
+        elapsed[blitter] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("Tested: %u px, %u spans", tests[BENCHMARK_BLIT_TESTED],
+        tests[blitSpans]);
+    benchmarkPrintf("Written: %u px", writtenPixels
+        / (BENCHMARK_RENDER_ITERATIONS + 1));
+    benchmarkPrintf("Blit: %u/%u/%u/%u us", elapsed[BENCHMARK_BLIT_TESTED],
+        elapsed[blitSpans], elapsed[blitMaskedSse2],
+        elapsed[blitMaskedAvx2]);
+    free(pRendered);
+    return;
+}
+
+/*
+ * The "benchmarkRenderScene" function renders the scene of the render
+ * benchmark once, by the passed blitter. The number of pixels tested or
+ * spans visited is returned, and the written pixels are added to the
+ * passed count.
+ */
+
+__forceinline UINT32 benchmarkRenderScene(
+        sPixel* const restrict pDestination,
+        const UINT8 blitter,
+        UINT32* const restrict pWrittenPixels) {
+
+    UINT32 tests = 0;
+    const sSpanImage* pImage;
+    sPixel* pImageDestination;
+    UINT32 spriteOffset = 0;
+    const UINT16 tiles = BACKBUFFER_WIDTH / TILE_SIZE * COLUMN_SIZE;
+    for (UINT16 i = 0; i < tiles; i++) {
+        pImage = fetchTileImage(gLevel.pTilemap[i]);
+        // Tiles are stored column by column, from the bottom row upwards.
+        pImageDestination = pDestination
+            + i % COLUMN_SIZE * TILE_SIZE * BACKBUFFER_WIDTH
+            + i / COLUMN_SIZE * TILE_SIZE;
+        tests += benchmarkRenderImage(pImageDestination, pImage, blitter,
+            pWrittenPixels);
+    }
+    // Sprites are rendered one after the other along the bottom of the
+    // scene, over the tiles.
+    for (UINT8 moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {
+        for (UINT16 frame = 0;
+                frame < 2 * gCharacterMolds[moldId].frames;
+                frame++) {
+            pImage = fetchMoldFrame(moldId, frame / 2, frame % 2);
+            if (pImage == NULL) {
+                continue;
+            }
+            if (spriteOffset + pImage->width > BACKBUFFER_WIDTH) {
+                spriteOffset = 0;
+            }
+            tests += benchmarkRenderImage(pDestination + spriteOffset,
+                pImage, blitter, pWrittenPixels);
+            spriteOffset += pImage->width;
+        }
+    }
+    return tests;
+}
+
+/*
+ * The "benchmarkRenderImage" function renders a single image of the scene
+ * of the render benchmark, whole, by the passed blitter. The number of
+ * pixels tested or spans visited is returned, and the written pixels are
+ * added to the passed count.
+ */
+
+__forceinline UINT32 benchmarkRenderImage(
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const UINT8 blitter,
+        UINT32* const restrict pWrittenPixels) {
+
+    if (blitter == BENCHMARK_BLIT_TESTED) {
+        return renderTestedPixels(pDestination, pImage, pWrittenPixels);
+    }
+    renderSpanImageWith(blitter, pDestination, pImage,
+        (sRect) {0, 0, pImage->width, pImage->height});
+    const UINT16 spans = pImage->pRowSpans[pImage->height];
+    for (UINT16 i = 0; i < spans; i++) {
+        *pWrittenPixels += pImage->pSpans[i].length;
+    }
+    return spans;
+}
+
+/*
+ * The "benchmarkTileStrip" function compares rendering the tiles of the
+ * viewport tile by tile with rendering them from the tile strip, as the
+ * camera scrolls over the whole level one pixel at a time. The time to
+ * scroll a fixed number of times with each is printed in microseconds,
+ * which includes compositing the columns the strip exposes. The first
+ * camera position where the strip renders differently is printed. Tiles
+ * and the level must be initialized, and the backbuffer is rendered on.
+ */
+
+__forceinline void benchmarkTileStrip() {
+
+    if (gLevel.width < BACKBUFFER_WIDTH + TILE_SIZE) {
+        return;
+    }
+    // The viewport is cut off on both sides at most positions, such that
+    // one more column than fits in the backbuffer is rendered.
+    const UINT16 positions = gLevel.width - BACKBUFFER_WIDTH - TILE_SIZE + 1;
+    const UINT32 backbufferPixels = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    sPixel* const pGolden = malloc(backbufferPixels * sizeof(sPixel));
+    if (pGolden == NULL) {
+        return;
+    }
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    for (UINT16 i = 0; i < positions; i++) {
+        memset(pBackbuffer, 0x00, backbufferPixels * sizeof(sPixel));
+        renderTileViewport(i, FALSE);
+        memcpy(pGolden, pBackbuffer, backbufferPixels * sizeof(sPixel));
+        memset(pBackbuffer, 0x00, backbufferPixels * sizeof(sPixel));
+        renderTileViewport(i, TRUE);
+        if (memcmp(pGolden, pBackbuffer,
+                backbufferPixels * sizeof(sPixel)) != 0) {
+            benchmarkPrintf("Strip differs at %u!", i);
+            break;
+        }
+    }
+    free(pGolden);
+    
+    UINT32 elapsed[2];
+    UINT64 start;
+    for (UINT8 isFromStrip = FALSE; isFromStrip <= TRUE; isFromStrip++) {
+        // Every column is composited again, as if the level was entered.
+        memset(gStripColumns, 0x00, sizeof(gStripColumns));
+        start = queryMicroseconds();
+        for (UINT8 j = 0; j < BENCHMARK_STRIP_ITERATIONS; j++) {
+            for (UINT16 i = 0; i < positions; i++) {
+                renderTileViewport(i, isFromStrip);
+            }
+        }
+        elapsed[isFromStrip] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("Tiles: %u/%u us", elapsed[FALSE], elapsed[TRUE]);
+    return;
+}
+
+/*
+ * The "renderTileViewport" function renders the tiles of the viewport of
+ * the passed camera position on the backbuffer, either tile by tile or from
+ * the tile strip.
+ */
+
+__forceinline void renderTileViewport(
+        const UINT16 cameraLeftPosX,
+        const BOOLEAN isFromStrip) {
+
+    const UINT16 firstColumn = cameraLeftPosX / TILE_SIZE;
+    const UINT8 tileStartX = cameraLeftPosX % TILE_SIZE;
+    const UINT8 columns = BACKBUFFER_WIDTH / TILE_SIZE
+        + (tileStartX > 0 ? 1 : 0);
+    const sRect screen = {0, 0, BACKBUFFER_WIDTH, BACKBUFFER_HEIGHT};
+    if (isFromStrip) {
+        updateTileStrip(firstColumn, columns);
+        renderTileStrip(firstColumn, tileStartX, columns, screen);
+    } else {
+        renderTileColumns(firstColumn * COLUMN_SIZE, tileStartX, columns,
+            screen);
+    }
+    return;
+}
+
+/*
+ * The "benchmarkRenderModes" function compares rendering a scene layer
+ * after layer with every other render mode, for each state of the screen.
+ * The camera stands at the left end of the level, at its middle, and at its
+ * right end, such that tiles are cut off on both sides while scrolling.
+ * Every mold renders its first frame as a sprite, along the bottom of the
+ * screen. The time to render the whole screen a fixed number of times in
+ * each mode is printed in microseconds, and scenes that the modes render
+ * differently are printed. Banded rendering is benchmarked last. Tiles,
+ * molds, the level and the background must be initialized, and the
+ * backbuffer is rendered on.
+ */
+
+__forceinline void benchmarkRenderModes(
+        const sPixel* const restrict pBackground) {
+
+    if (gLevel.width < BACKBUFFER_WIDTH + 2 * TILE_SIZE) {
+        return;
+    }
+    sPixel* const pGolden = malloc(BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT
+        * sizeof(sPixel));
+    if (pGolden == NULL) {
+        return;
+    }
+    // The middle camera position is moved off the tile grid, such that
+    // tiles are cut off on both sides of the screen.
+    benchmarkRenderMode("Left", 0, pBackground, pGolden);
+    benchmarkRenderMode("Scrolling",
+        (gLevel.width - BACKBUFFER_WIDTH) / 2 | (TILE_SIZE / 2),
+        pBackground, pGolden);
+    benchmarkRenderMode("Right", gLevel.width - BACKBUFFER_WIDTH,
+        pBackground, pGolden);
+    benchmarkRenderBands(pBackground, pGolden);
+    free(pGolden);
+    return;
+}
+
+/*
+ * The "benchmarkRenderMode" function renders the scene of the passed
+ * camera position in every render mode, and prints the time each takes
+ * under the passed name. The golden buffer holds the scene rendered layer
+ * after layer, which the other modes are compared with.
+ */
+
+__forceinline void benchmarkRenderMode(
+        const CHAR* const restrict pName,
+        const UINT16 cameraLeftPosX,
+        const sPixel* const restrict pBackground,
+        sPixel* const restrict pGolden) {
+
+    const UINT32 backbufferPixels = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    sSpriteDraw sprites[CHARACTER_VARIETY];
+    const sScene scene = buildBenchmarkScene(cameraLeftPosX, pBackground,
+        sprites);
+    const sRect screen = {0, 0, BACKBUFFER_WIDTH, BACKBUFFER_HEIGHT};
+    updateTileStrip(scene.firstTileColumn, scene.tileColumns);
+    sSceneFrames frames;
+    fetchSceneFrames(&scene, screen, &frames);
+    sOverdraw overdraw = {0};
+    
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    UINT32 elapsed[RENDER_MODE_VARIETY];
+    UINT64 start;
+    for (UINT8 mode = 0; mode < RENDER_MODE_VARIETY; mode++) {
+        memset(pBackbuffer, 0x00, backbufferPixels * sizeof(sPixel));
+        renderSceneWith(mode, &scene, &frames, screen, &overdraw);
+        if (mode == renderLayered) {
+            memcpy(pGolden, pBackbuffer, backbufferPixels * sizeof(sPixel));
+        } else if (memcmp(pBackbuffer, pGolden,
+                backbufferPixels * sizeof(sPixel)) != 0) {
+            benchmarkPrintf("%s mode %u differs!", pName, mode);
+        }
+        start = queryMicroseconds();
+        for (UINT16 i = 0; i < BENCHMARK_SCENE_ITERATIONS; i++) {
+            renderSceneWith(mode, &scene, &frames, screen, &overdraw);
+        }
+        elapsed[mode] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("%s: %u/%u/%u us", pName, elapsed[renderLayered],
+        elapsed[renderScanline], elapsed[renderFrontToBack]);
+    benchmarkPrintf("%s indexed: %u us", pName, elapsed[renderIndexed]);
+    return;
+}
+
+/*
+ * The "benchmarkRenderBands" function compares rendering a scene on the
+ * calling thread alone with rendering it in as many bands as there are
+ * workers. The resolution of the backbuffer is fixed at compile time, such
+ * that rectangles as wide as the screen and ever taller stand for growing
+ * resolutions. The time to render each rectangle a fixed number of times
+ * either way is printed in microseconds, along with the number of rows of
+ * the rectangle, and rectangles that either way renders differently are
+ * printed. The passed golden buffer must hold as many pixels as the
+ * backbuffer, whose contents it receives.
+ */
+
+__forceinline void benchmarkRenderBands(
+        const sPixel* const restrict pBackground,
+        sPixel* const restrict pGolden) {
+
+    const UINT32 backbufferPixels = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    sSpriteDraw sprites[CHARACTER_VARIETY];
+    const sScene scene = buildBenchmarkScene(
+        (gLevel.width - BACKBUFFER_WIDTH) / 2 | (TILE_SIZE / 2), pBackground,
+        sprites);
+    updateTileStrip(scene.firstTileColumn, scene.tileColumns);
+    const UINT8 bands = gTaskPool.threads + 1;
+    benchmarkPrintf("Bands: %u", bands);
+    
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    sSceneFrames frames;
+    sOverdraw overdraw = {0};
+    sRect clip;
+    UINT32 elapsed[2];
+    UINT64 start;
+    for (UINT16 rows = BENCHMARK_BAND_MIN_ROWS; rows <= BACKBUFFER_HEIGHT;
+            rows *= 2) {
+        clip = (sRect) {0, 0, BACKBUFFER_WIDTH, rows};
+        fetchSceneFrames(&scene, clip, &frames);
+        memset(pBackbuffer, 0x00, backbufferPixels * sizeof(sPixel));
+        renderSceneBands(gRenderMode, &scene, &frames, clip, 1, &overdraw);
+        memcpy(pGolden, pBackbuffer, backbufferPixels * sizeof(sPixel));
+        memset(pBackbuffer, 0x00, backbufferPixels * sizeof(sPixel));
+        renderSceneBands(gRenderMode, &scene, &frames, clip, bands,
+            &overdraw);
+        if (memcmp(pBackbuffer, pGolden,
+                backbufferPixels * sizeof(sPixel)) != 0) {
+            benchmarkPrintf("%u rows differ!", rows);
+        }
+        for (UINT8 i = 0; i < 2; i++) {
+            start = queryMicroseconds();
+            for (UINT16 j = 0; j < BENCHMARK_SCENE_ITERATIONS; j++) {
+                renderSceneBands(gRenderMode, &scene, &frames, clip,
+                    i == 0 ? 1 : bands, &overdraw);
+            }
+            elapsed[i] = queryMicroseconds() - start;
+        }
+        benchmarkPrintf("%u rows: %u/%u us", rows, elapsed[0], elapsed[1]);
+    }
+    return;
+}
+
+/*
+ * The "benchmarkExpand" function expands the whole indexed backbuffer on
+ * the window backbuffer by every way that the processor supports. The time
+ * to expand it a fixed number of times is printed in microseconds for each
+ * way, and ways that expand it differently than the table are printed.
+ * Unsupported ways are timed as zero. The indexed backbuffer is expanded as
+ * the latest scene rendered in the indexed mode left it.
+ */
+
+__forceinline void benchmarkExpand() {
+
+    const UINT32 backbufferPixels = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    sPixel* const pGolden = malloc(backbufferPixels * sizeof(sPixel));
+    if (pGolden == NULL) {
+        return;
+    }
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    UINT32 elapsed[EXPANDER_VARIETY] = {0};
+    UINT64 start;
+    for (UINT8 expander = 0; expander <= selectExpander(); expander++) {
+        expandIndexedPixelsWith(expander, gIndexedBackbuffer,
+            backbufferPixels, pBackbuffer);
+        if (expander == expandScalar) {
+            memcpy(pGolden, pBackbuffer, backbufferPixels * sizeof(sPixel));
+        } else if (memcmp(pBackbuffer, pGolden,
+                backbufferPixels * sizeof(sPixel)) != 0) {
+            benchmarkPrintf("Expander %u differs!", expander);
+        }
+        start = queryMicroseconds();
+        for (UINT16 i = 0; i < BENCHMARK_EXPAND_ITERATIONS; i++) {
+            expandIndexedPixelsWith(expander, gIndexedBackbuffer,
+                backbufferPixels, pBackbuffer);
+        }
+        elapsed[expander] = queryMicroseconds() - start;
+    }
+    benchmarkPrintf("Expand: %u/%u/%u us", elapsed[expandScalar],
+        elapsed[expandSsse3], elapsed[expandAvx2]);
+    free(pGolden);
+    return;
+}
+
+/*
+ * The "benchmarkUpscale" function scales the backbuffer up on windows of
+ * common screen resolutions by every upscaler that the processor supports.
+ * The average time to scale the backbuffer up once is printed in
+ * microseconds for each upscaler, along with the scale, and upscalers that
+ * scale it differently than the scalar one are printed. Unsupported
+ * upscalers are timed as zero.
+ */
+
+__forceinline void benchmarkUpscale() {
+
+    const UINT16 heights[] = BENCHMARK_UPSCALE_HEIGHTS;
+    const UINT8 windows = sizeof(heights) / sizeof(heights[0]);
+    const UINT32 maxPixels = heights[windows - 1] * 16 / 9
+        * heights[windows - 1];
+    sPixel* const pWindow = malloc(2 * maxPixels * sizeof(sPixel));
+    if (pWindow == NULL) {
+        return;
+    }
+    sPixel* const pGolden = pWindow + maxPixels;
+    sUpscaleTarget target;
+    UINT32 elapsed[UPSCALER_VARIETY];
+    UINT32 pixels;
+    UINT64 start;
+    for (UINT8 i = 0; i < windows; i++) {
+        placeUpscaleTarget(&target, pWindow, heights[i] * 16 / 9,
+            heights[i] * 16 / 9, heights[i]);
+        pixels = target.width * target.height;
+        memset(elapsed, 0x00, sizeof(elapsed));
+        for (UINT8 upscaler = 0; upscaler <= selectUpscaler(); upscaler++) {
+            clearUpscaleTarget(&target);
+            upscaleBackbufferWith(upscaler, &target, gBackbuffer.pPixelData);
+            if (upscaler == upscaleScalar) {
+                memcpy(pGolden, pWindow, pixels * sizeof(sPixel));
+            } else if (memcmp(pWindow, pGolden,
+                    pixels * sizeof(sPixel)) != 0) {
+                benchmarkPrintf("Upscaler %u differs!", upscaler);
+            }
+            start = queryMicroseconds();
+            for (UINT16 j = 0; j < BENCHMARK_UPSCALE_ITERATIONS; j++) {
+                upscaleBackbufferWith(upscaler, &target,
+                    gBackbuffer.pPixelData);
+            }
+            elapsed[upscaler] = (queryMicroseconds() - start)
+                / BENCHMARK_UPSCALE_ITERATIONS;
+        }
+        benchmarkPrintf("%up x%u: %u/%u/%u us", heights[i], target.scale,
+            elapsed[upscaleScalar], elapsed[upscaleSsse3],
+            elapsed[upscaleAvx2]);
+    }
+    free(pWindow);
+    return;
+}
+
+/*
+ * The "buildBenchmarkScene" function returns the scene of the passed camera
+ * position. Every mold renders its first frame as a sprite, along the
+ * bottom of the screen, which the passed array describes.
+ */
+
+__forceinline sScene buildBenchmarkScene(
+        const UINT16 cameraLeftPosX,
+        const sPixel* const restrict pBackground,
+        sSpriteDraw sprites[const static CHARACTER_VARIETY]) {
+
+    UINT16 spriteOffset = 0;
+    for (UINT8 moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {
+        const sCollision dimensions = gCharacterMolds[moldId].collision;
+        if (spriteOffset + dimensions.width > BACKBUFFER_WIDTH) {
+            spriteOffset = 0;
+        }
+        sprites[moldId] = (sSpriteDraw) {
+            clipSpriteRect((sPosition) {spriteOffset, TILE_SIZE},
+                dimensions.width, dimensions.height),
+            moldId,
+            0,
+            0,
+            gCharacterMolds[moldId].frames > 0};
+        spriteOffset += dimensions.width;
+    }
+    const UINT8 tileStartX = cameraLeftPosX % TILE_SIZE;
+    return (sScene) {
+        pBackground,
+        sprites,
+        CHARACTER_VARIETY,
+        cameraLeftPosX / TILE_SIZE,
+        tileStartX,
+        BACKBUFFER_WIDTH / TILE_SIZE + (tileStartX > 0 ? 1 : 0)};
+}
+
+/*
+ * The "renderTestedPixels" function renders an image by testing every pixel
+ * against the transparent color, as rendering did before opaque spans. The
+ * number of tested pixels is returned, and the written pixels are added to
+ * the passed count.
+ */
+
+__forceinline UINT32 renderTestedPixels(
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        UINT32* const restrict pWrittenPixels) {
+
+    const UINT8* pRow = pImage->pIndexedPixels;
+    sPixel* pDestinationRow = pDestination;
+    for (UINT8 row = 0; row < pImage->height; row++) {
+        for (UINT8 column = 0; column < pImage->width; column++) {
+            if (pRow[column] == PALETTE_TRANSPARENT) {
+                continue;
+            }
+            pDestinationRow[column] = gColor332ToPixel[pRow[column]];
+            (*pWrittenPixels)++;
+        }
+        pRow += pImage->width;
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return pImage->width * pImage->height;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+
+#include "coordinator.h"
+#include "read.h"
+#include "prop_dir.h"
+
+/*
+ * The functions of this file manage the decoded asset cache. Every decoded
+ * graphic asset is saved in its own cache file, which holds a header
+ * followed by the decoded pixels. The header features the key of the
+ * source bytes the pixels were decoded from. A cache file is only used if
+ * its key matches the one of the current source bytes. Otherwise, the asset
+ * is decoded again and its cache file is overwritten.
+ */
+
+// The version below must be incremented whenever the decoded output of a
+// source asset changes. Cache files of other versions are rebuilt.
+#define DECODER_VERSION 1
+
+#define CACHE_MAGIC "FCDC"
+// The header features the four magic characters, the decoder version, the
+// 64-bit key and the number of pixels. All integers are little-endian.
+#define CACHE_HEADER_BYTES 20
+
+__forceinline UINT64 hashBytes(
+    const BYTE* const restrict pData,
+    UINT32 size,
+    const UINT64 seed);
+
+__forceinline BOOLEAN readDecodedCache(
+    const CHAR* const restrict pDir,
+    const UINT64 key,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+__forceinline void writeDecodedCache(
+    const CHAR* const restrict pDir,
+    const UINT64 key,
+    const UINT32 pixels,
+    const sPixel* const restrict pSource);
+
+// The counters below describe how many assets were read from the cache
+// and how many had to be decoded since the application started. Loaders
+// running concurrently increment them atomically.
+volatile LONG gDecodedCacheHits = 0;
+volatile LONG gDecodedCacheMisses = 0;
+
+/*
+ * The "hashBytes" function computes a 64-bit key of the passed bytes. It is
+ * not cryptographic. It reads 8 bytes at a time and mixes every word with
+ * multiplications and shifts such that any changed byte changes the key.
+ * The decoder version is expected to be part of the seed.
+ */
+
+__forceinline UINT64 hashBytes(
+        const BYTE* const restrict pData,
+        UINT32 size,
+        const UINT64 seed) {
+
+    UINT64 hash = seed ^ (size * 0x9E3779B97F4A7C15ULL);
+    UINT64 word;
+    const BYTE* pWord = pData;
+    for (; size >= sizeof(word); size -= sizeof(word),
+            pWord += sizeof(word)) {
+        memcpy(&word, pWord, sizeof(word));
+        word *= 0xBF58476D1CE4E5B9ULL;
+        word ^= word >> 31;
+        hash = (hash ^ word) * 0x94D049BB133111EBULL;
+    }
+    // The remaining bytes are padded with zeros. The size mixed in the seed
+    // distinguishes them from bytes that are actually zero.
+    word = 0;
+    memcpy(&word, pWord, size);
+    word *= 0xBF58476D1CE4E5B9ULL;
+    word ^= word >> 31;
+    hash = (hash ^ word) * 0x94D049BB133111EBULL;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/*
+ * The "readDecodedCache" function copies the pixels of the cache file found
+ * at the passed directory to the destination. It returns "TRUE" only if the
+ * cache file exists, matches the passed key and decoder version, and holds
+ * exactly the passed number of pixels.
+ */
+
+__forceinline BOOLEAN readDecodedCache(
+        const CHAR* const restrict pDir,
+        const UINT64 key,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+
+    sMappedFile file;
+    if (mapFile(pDir, &file) != ERROR_SUCCESS) {
+        InterlockedIncrement(&gDecodedCacheMisses);
+        return FALSE;
+    }
+    UINT32 version;
+    UINT64 cachedKey;
+    UINT32 cachedPixels;
+    BOOLEAN isValid = file.size == CACHE_HEADER_BYTES
+        + (UINT64) pixels * sizeof(sPixel)
+        && memcmp(file.pData, CACHE_MAGIC, 4) == 0;
+    if (isValid) {
+        memcpy(&version, file.pData + 4, sizeof(version));
+        memcpy(&cachedKey, file.pData + 8, sizeof(cachedKey));
+        memcpy(&cachedPixels, file.pData + 16, sizeof(cachedPixels));
+        isValid = version == DECODER_VERSION && cachedKey == key
+            && cachedPixels == pixels;
+    }
+    if (isValid) {
+        memcpy(pDestination, file.pData + CACHE_HEADER_BYTES,
+            pixels * sizeof(sPixel));
+        InterlockedIncrement(&gDecodedCacheHits);
+    } else {
+        InterlockedIncrement(&gDecodedCacheMisses);
+    }
+    unmapFile(&file);
+    return isValid;
+}
+
+/*
+ * The "writeDecodedCache" function overwrites the cache file found at the
+ * passed directory with the passed pixels. The cache directory is created
+ * if it is absent. Failing to write a cache file is not an error, since the
+ * asset is simply decoded again on the next execution.
+ */
+
+__forceinline void writeDecodedCache(
+        const CHAR* const restrict pDir,
+        const UINT64 key,
+        const UINT32 pixels,
+        const sPixel* const restrict pSource) {
+
+#ifdef _WIN32
+    CreateDirectory(DIR_CACHE, NULL);
+#else
+    mkdir(DIR_CACHE, 0755);
+#endif
+    FILE* const pFile = fopen(pDir, "wb");
+    if (pFile == NULL) {
+        return;
+    }
+    const UINT32 version = DECODER_VERSION;
+    fwrite(CACHE_MAGIC, 1, 4, pFile);
+    fwrite(&version, sizeof(version), 1, pFile);
+    fwrite(&key, sizeof(key), 1, pFile);
+    fwrite(&pixels, sizeof(pixels), 1, pFile);
+    const size_t writtenPixels = fwrite(pSource, sizeof(sPixel), pixels,
+        pFile);
+    // A partially written cache file is removed. Its size would not match
+    // its header anyway, but it would be read on every execution.
+    if (fclose(pFile) != 0 || writtenPixels != pixels) {
+        remove(pDir);
+    }
+    return;
+}
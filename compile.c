@@ -0,0 +1,510 @@
+// This code is designed to be compiled with GCC.
+// The asset compiler builds graphic assets from uncompressed Netpbm images,
+// which are binary PPM ("P6") or PAM ("P7") files. It is executed in one of
+// the following ways:
+//     compile.exe bci <output> <image>
+//     compile.exe tmp <output> <sheet>...
+//     compile.exe mld <mold> <graphic> <max speed> <width> <height> <sheet>...
+// The first form writes a single binary number-coded image. The second cuts
+// every sheet in tiles, from left to right then from top to bottom, and
+// writes them one after the other as a texture map. The third cuts every
+// sheet in animation frames of the passed size the same way, then writes
+// the mold file and the graphics of all frames as a single image. Colors are
+// reduced to the 3-3-2 format of palettes. Pixels of the transparent palette
+// color, as well as PAM pixels less than half opaque, are transparent.
+// Images are written with their bottom row first, as they are rendered.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "encode.h"
+
+// Tiles of texture maps are squares of the size below, in pixels, which
+// matches the "TILE_SIZE" macro of the application.
+#define COMPILE_TILE_SIZE 16
+
+// Netpbm header tokens, such as PAM tuple types, are shorter than the size
+// below.
+#define COMPILE_TOKEN_SIZE 32
+
+/*
+ * This section establishes data structures used throughout this file, and no
+ * other program.
+ */
+
+// The struct below describes a source image. Its colors are reduced to the
+// 3-3-2 format, and stored from the top to the bottom row.
+typedef struct {
+    uint32_t width;
+    uint32_t height;
+    uint8_t* pColors;
+} sSourceImage;
+
+// The struct below counts the pixels featuring a palette color, such that
+// palettes can be sorted.
+typedef struct {
+    uint32_t pixels;
+    uint8_t color;
+} sPaletteEntry;
+
+/*
+ * This section establishes and outlines function symbols used thoughout
+ * this program.
+ */
+
+int readSourceImage(
+    const char* const restrict pDir,
+    sSourceImage* const restrict pImage);
+
+int readHeaderToken(
+    const uint8_t** const restrict ppRead,
+    const uint8_t* const restrict pEnd,
+    char* const restrict pToken);
+
+uint8_t reduceColor(
+    const uint32_t red,
+    const uint32_t green,
+    const uint32_t blue,
+    const uint32_t alpha,
+    const uint32_t maxValue);
+
+uint8_t* cutSourceImages(
+    const sSourceImage* const restrict pSheets,
+    const uint32_t sheets,
+    const uint32_t width,
+    const uint32_t height,
+    uint32_t* const restrict pImages);
+
+uint32_t writeImage(
+    FILE* const restrict pFile,
+    const uint8_t* const restrict pColors,
+    const uint32_t pixels,
+    uint8_t* const restrict pColorCodeBits);
+
+/*
+ * The function below is the entry point to the asset compiler. It reads
+ * every source image, cuts them in images of the size required by the type
+ * of asset, and writes the asset files.
+ */
+
+int main(int argc, char** argv) {
+
+    const int isTextureMap = argc > 3 && strcmp(argv[1], "tmp") == 0;
+    const int isMold = argc > 7 && strcmp(argv[1], "mld") == 0;
+    if (!isTextureMap && !isMold
+            && (argc != 4 || strcmp(argv[1], "bci") != 0)) {
+        fprintf(stderr, "Usage: %s bci <output> <image>\n"
+            "       %s tmp <output> <sheet>...\n"
+            "       %s mld <mold> <graphic> <max speed> <width> <height> "
+            "<sheet>...\n", argv[0], argv[0], argv[0]);
+        return EXIT_FAILURE;
+    }
+    const int firstSheet = isMold ? 7 : 3;
+    const char* const pOutputDir = isMold ? argv[3] : argv[2];
+
+    // The size of the images cut from the sheets depends on the asset.
+    // Single images are as large as their only sheet.
+    uint32_t width = COMPILE_TILE_SIZE;
+    uint32_t height = COMPILE_TILE_SIZE;
+    uint32_t maxSpeed = 0;
+    if (isMold) {
+        maxSpeed = strtoul(argv[4], NULL, 10);
+        width = strtoul(argv[5], NULL, 10);
+        height = strtoul(argv[6], NULL, 10);
+        if (maxSpeed > UINT8_MAX || width == 0 || width > UINT8_MAX
+                || height == 0 || height > UINT8_MAX) {
+            fprintf(stderr, "Mold sizes and speeds range up to %u.\n",
+                UINT8_MAX);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const uint32_t sheets = (uint32_t) (argc - firstSheet);
+    sSourceImage* const pSheets = calloc(sheets, sizeof(sSourceImage));
+    if (pSheets == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return EXIT_FAILURE;
+    }
+    int result = EXIT_SUCCESS;
+    for (uint32_t i = 0; i < sheets; i++) {
+        if (readSourceImage(argv[firstSheet + i], &pSheets[i]) != 0) {
+            fprintf(stderr, "Image file %s could not be read.\n",
+                argv[firstSheet + i]);
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+    if (result == EXIT_SUCCESS && !isTextureMap && !isMold) {
+        width = pSheets[0].width;
+        height = pSheets[0].height;
+    }
+
+    uint32_t images = 0;
+    uint8_t* const pColors = result == EXIT_SUCCESS
+        ? cutSourceImages(pSheets, sheets, width, height, &images) : NULL;
+    for (uint32_t i = 0; i < sheets; i++) {
+        free(pSheets[i].pColors);
+    }
+    free(pSheets);
+    if (pColors == NULL) {
+        if (result == EXIT_SUCCESS) {
+            fprintf(stderr, "Images could not be cut in %ux%u images.\n",
+                width, height);
+        }
+        return EXIT_FAILURE;
+    }
+    if (isMold && images > UINT8_MAX) {
+        fprintf(stderr, "Molds feature at most %u frames.\n", UINT8_MAX);
+        free(pColors);
+        return EXIT_FAILURE;
+    }
+
+    FILE* const pFile = fopen(pOutputDir, "wb");
+    if (pFile == NULL) {
+        fprintf(stderr, "Image file %s could not be created.\n", pOutputDir);
+        free(pColors);
+        return EXIT_FAILURE;
+    }
+    // Tiles of texture maps feature a palette each, whereas the frames of a
+    // mold share the palette of their single image.
+    const uint32_t imagePixels = width * height;
+    const uint32_t writtenImages = isTextureMap ? images : 1;
+    const uint32_t writtenPixels = isTextureMap ? imagePixels
+        : imagePixels * images;
+    uint32_t outputSize = 0;
+    uint32_t imageSize;
+    uint8_t colorCodeBits;
+    uint8_t maxColorCodeBits = 0;
+    for (uint32_t i = 0; i < writtenImages; i++) {
+        imageSize = writeImage(pFile, pColors + i * writtenPixels,
+            writtenPixels, &colorCodeBits);
+        if (imageSize == 0) {
+            fprintf(stderr, "Image %u of %s features too many colors.\n",
+                i, pOutputDir);
+            result = EXIT_FAILURE;
+            break;
+        }
+        outputSize += imageSize;
+        if (colorCodeBits > maxColorCodeBits) {
+            maxColorCodeBits = colorCodeBits;
+        }
+    }
+    free(pColors);
+    if (fclose(pFile) != 0 || result != EXIT_SUCCESS) {
+        fprintf(stderr, "Image file %s could not be written.\n", pOutputDir);
+        remove(pOutputDir);
+        return EXIT_FAILURE;
+    }
+    printf("Compiled %u images to %s (%u bytes, up to %u-bit codes).\n",
+        images, pOutputDir, outputSize, maxColorCodeBits);
+
+    if (isMold) {
+        // The mold file features the collision width and height, the
+        // maximum horizontal speed and the number of frames, in a byte each.
+        const uint8_t moldInfo[4] = {
+            (uint8_t) width, (uint8_t) height, (uint8_t) maxSpeed,
+            (uint8_t) images};
+        FILE* const pMoldFile = fopen(argv[2], "wb");
+        if (pMoldFile == NULL
+                || fwrite(moldInfo, 1, sizeof(moldInfo), pMoldFile)
+                != sizeof(moldInfo)
+                || fclose(pMoldFile) != 0) {
+            fprintf(stderr, "Mold file %s could not be written.\n", argv[2]);
+            remove(argv[2]);
+            return EXIT_FAILURE;
+        }
+        printf("Compiled the mold of %u %ux%u frames to %s.\n", images,
+            width, height, argv[2]);
+    }
+    return EXIT_SUCCESS;
+}
+
+/*
+ * The "readSourceImage" function reads the PPM or PAM image found at the
+ * passed directory, and reduces its colors. Samples of one or two bytes are
+ * supported, as are grayscale tuples and tuples featuring an alpha channel.
+ * The caller frees the colors of the image. Zero is returned on success.
+ */
+
+int readSourceImage(
+        const char* const restrict pDir,
+        sSourceImage* const restrict pImage) {
+
+    uint32_t size;
+    uint8_t* const pContents = readFile(pDir, &size);
+    if (pContents == NULL) {
+        return 1;
+    }
+    const uint8_t* pRead = pContents;
+    const uint8_t* const pEnd = pContents + size;
+    char token[COMPILE_TOKEN_SIZE];
+    uint32_t depth = 3;
+    uint32_t maxValue = 0;
+    pImage->width = 0;
+    pImage->height = 0;
+    pImage->pColors = NULL;
+
+    int result = readHeaderToken(&pRead, pEnd, token);
+    if (result == 0 && strcmp(token, "P6") == 0) {
+        // PPM headers feature the width, height and maximum sample value.
+        result |= readHeaderToken(&pRead, pEnd, token);
+        pImage->width = strtoul(token, NULL, 10);
+        result |= readHeaderToken(&pRead, pEnd, token);
+        pImage->height = strtoul(token, NULL, 10);
+        result |= readHeaderToken(&pRead, pEnd, token);
+        maxValue = strtoul(token, NULL, 10);
+    } else if (result == 0 && strcmp(token, "P7") == 0) {
+        // PAM headers feature pairs of keywords and values, in any order.
+        // The tuple type is implied by the depth.
+        while ((result = readHeaderToken(&pRead, pEnd, token)) == 0
+                && strcmp(token, "ENDHDR") != 0) {
+            if (strcmp(token, "WIDTH") == 0) {
+                result = readHeaderToken(&pRead, pEnd, token);
+                pImage->width = strtoul(token, NULL, 10);
+            } else if (strcmp(token, "HEIGHT") == 0) {
+                result = readHeaderToken(&pRead, pEnd, token);
+                pImage->height = strtoul(token, NULL, 10);
+            } else if (strcmp(token, "DEPTH") == 0) {
+                result = readHeaderToken(&pRead, pEnd, token);
+                depth = strtoul(token, NULL, 10);
+            } else if (strcmp(token, "MAXVAL") == 0) {
+                result = readHeaderToken(&pRead, pEnd, token);
+                maxValue = strtoul(token, NULL, 10);
+            } else if (strcmp(token, "TUPLTYPE") == 0) {
+                result = readHeaderToken(&pRead, pEnd, token);
+            }
+            if (result != 0) {
+                break;
+            }
+        }
+    } else {
+        result = 1;
+    }
+    // A single whitespace separates the header from the samples.
+    if (pRead == pEnd) {
+        result = 1;
+    }
+    pRead += result == 0;
+
+    const uint32_t sampleBytes = maxValue > UINT8_MAX ? 2 : 1;
+    const uint64_t pixels = (uint64_t) pImage->width * pImage->height;
+    if (result != 0 || pImage->width == 0 || pImage->height == 0
+            || depth == 0 || depth > 4 || maxValue == 0
+            || maxValue > UINT16_MAX
+            || (uint64_t) (pEnd - pRead) < pixels * depth * sampleBytes) {
+        free(pContents);
+        return 1;
+    }
+    pImage->pColors = malloc(pixels);
+    if (pImage->pColors == NULL) {
+        free(pContents);
+        return 1;
+    }
+
+    // Grayscale tuples feature a single color sample, and the alpha sample,
+    // if any, is the last sample of a tuple.
+    const uint32_t colorSamples = depth < 3 ? 1 : 3;
+    const int hasAlpha = depth == 2 || depth == 4;
+    uint32_t samples[4];
+    for (uint64_t i = 0; i < pixels; i++) {
+        for (uint32_t j = 0; j < depth; j++) {
+            samples[j] = sampleBytes == 2
+                ? (uint32_t) (pRead[0] << 8 | pRead[1]) : pRead[0];
+            pRead += sampleBytes;
+        }
+        pImage->pColors[i] = reduceColor(
+            samples[0],
+            samples[colorSamples == 3 ? 1 : 0],
+            samples[colorSamples == 3 ? 2 : 0],
+            hasAlpha ? samples[depth - 1] : maxValue,
+            maxValue);
+    }
+    free(pContents);
+    return 0;
+}
+
+/*
+ * The "readHeaderToken" function copies the next token of a Netpbm header,
+ * skipping whitespace and comments, and advances the read address past it.
+ * Zero is returned on success, and tokens that are too long fail.
+ */
+
+int readHeaderToken(
+        const uint8_t** const restrict ppRead,
+        const uint8_t* const restrict pEnd,
+        char* const restrict pToken) {
+
+    const uint8_t* pRead = *ppRead;
+    while (pRead < pEnd && (*pRead == ' ' || *pRead == '\t'
+            || *pRead == '\r' || *pRead == '\n' || *pRead == '#')) {
+        if (*pRead == '#') {
+            while (pRead < pEnd && *pRead != '\n') {
+                pRead++;
+            }
+            continue;
+        }
+        pRead++;
+    }
+    uint32_t length = 0;
+    while (pRead < pEnd && *pRead != ' ' && *pRead != '\t'
+            && *pRead != '\r' && *pRead != '\n' && *pRead != '#') {
+        if (length + 1 == COMPILE_TOKEN_SIZE) {
+            return 1;
+        }
+        pToken[length++] = (char) *pRead++;
+    }
+    pToken[length] = '\0';
+    *ppRead = pRead;
+    return length == 0;
+}
+
+/*
+ * The "reduceColor" function returns the 3-3-2 palette color of the passed
+ * samples. Samples are scaled to eight bits, then truncated, such that
+ * reducing a decoded pixel yields the palette color it was decoded from.
+ */
+
+uint8_t reduceColor(
+        const uint32_t red,
+        const uint32_t green,
+        const uint32_t blue,
+        const uint32_t alpha,
+        const uint32_t maxValue) {
+
+    if (alpha * 2 < maxValue) {
+        return PALETTE_TRANSPARENT;
+    }
+    const uint32_t scaledRed = red * UINT8_MAX / maxValue;
+    const uint32_t scaledGreen = green * UINT8_MAX / maxValue;
+    const uint32_t scaledBlue = blue * UINT8_MAX / maxValue;
+    return (uint8_t) ((scaledRed & 0xE0) | (scaledGreen >> 5) << 2
+        | scaledBlue >> 6);
+}
+
+/*
+ * The "cutSourceImages" function cuts every passed sheet in images of the
+ * passed size, from left to right then from top to bottom, and returns the
+ * colors of all images one after the other. The colors of every image are
+ * stored from its bottom to its top row. The number of images is saved. A
+ * null address is returned if a sheet cannot be cut in whole images.
+ */
+
+uint8_t* cutSourceImages(
+        const sSourceImage* const restrict pSheets,
+        const uint32_t sheets,
+        const uint32_t width,
+        const uint32_t height,
+        uint32_t* const restrict pImages) {
+
+    uint32_t images = 0;
+    for (uint32_t i = 0; i < sheets; i++) {
+        if (pSheets[i].width % width != 0
+                || pSheets[i].height % height != 0) {
+            return NULL;
+        }
+        images += pSheets[i].width / width * (pSheets[i].height / height);
+    }
+    uint8_t* const pColors = malloc((size_t) images * width * height);
+    if (pColors == NULL) {
+        return NULL;
+    }
+
+    uint8_t* pWrite = pColors;
+    const uint8_t* pRow;
+    for (uint32_t i = 0; i < sheets; i++) {
+        for (uint32_t top = 0; top < pSheets[i].height; top += height) {
+            for (uint32_t left = 0; left < pSheets[i].width;
+                    left += width) {
+                for (uint32_t row = height; row-- > 0;) {
+                    pRow = pSheets[i].pColors
+                        + (size_t) (top + row) * pSheets[i].width + left;
+                    memcpy(pWrite, pRow, width);
+                    pWrite += width;
+                }
+            }
+        }
+    }
+    *pImages = images;
+    return pColors;
+}
+
+/*
+ * The "writeImage" function writes the passed colors as a binary
+ * number-coded image, and returns the size of the written image. Zero is
+ * returned if the image cannot be written. The palette is sorted such that
+ * the transparent color, if featured, has code zero, and the remaining
+ * colors follow from the most to the least common. Color codes have the
+ * minimum length describing the highest code, which is saved.
+ */
+
+uint32_t writeImage(
+        FILE* const restrict pFile,
+        const uint8_t* const restrict pColors,
+        const uint32_t pixels,
+        uint8_t* const restrict pColorCodeBits) {
+
+    sPaletteEntry entries[256];
+    for (uint16_t i = 0; i < 256; i++) {
+        entries[i] = (sPaletteEntry) {0, (uint8_t) i};
+    }
+    for (uint32_t i = 0; i < pixels; i++) {
+        entries[pColors[i]].pixels++;
+    }
+    // Transparent pixels count as many as all pixels, such that their color
+    // precedes the others. Ties are broken by the lower color, such that
+    // palettes do not depend on the sort.
+    if (entries[PALETTE_TRANSPARENT].pixels > 0) {
+        entries[PALETTE_TRANSPARENT].pixels = pixels + 1;
+    }
+    sPaletteEntry entry;
+    uint16_t j;
+    for (uint16_t i = 1; i < 256; i++) {
+        entry = entries[i];
+        for (j = i; j > 0 && entries[j - 1].pixels < entry.pixels; j--) {
+            entries[j] = entries[j - 1];
+        }
+        entries[j] = entry;
+    }
+
+    // The color count of an image is stored in a byte, which cannot hold
+    // every color. Zero colors would otherwise mark run-length coded
+    // images.
+    uint16_t colors = 0;
+    while (colors < 256 && entries[colors].pixels > 0) {
+        colors++;
+    }
+    if (colors == 0 || colors > UINT8_MAX) {
+        return 0;
+    }
+    uint8_t palette[256];
+    uint8_t codes[256];
+    for (uint16_t i = 0; i < colors; i++) {
+        palette[i] = entries[i].color;
+        codes[entries[i].color] = (uint8_t) i;
+    }
+    uint8_t remainingCodes = (uint8_t) (colors - 1);
+    uint8_t colorCodeBits = 0;
+    do {
+        colorCodeBits++;
+    } while (remainingCodes >>= 1);
+
+    // The last byte of color codes is padded with zeros.
+    const uint32_t encodedBytes = (pixels * colorCodeBits + 7) / 8;
+    uint8_t* const pPackedCodes = calloc(encodedBytes, 1);
+    if (pPackedCodes == NULL) {
+        return 0;
+    }
+    for (uint32_t i = 0; i < pixels; i++) {
+        writePackedColorCode(pPackedCodes, colorCodeBits, i,
+            codes[pColors[i]]);
+    }
+    const uint8_t colorCount = (uint8_t) colors;
+    const int isWritten = fwrite(&colorCount, 1, 1, pFile) == 1
+        && fwrite(palette, 1, colors, pFile) == colors
+        && fwrite(pPackedCodes, 1, encodedBytes, pFile) == encodedBytes;
+    free(pPackedCodes);
+    *pColorCodeBits = colorCodeBits;
+    return isWritten ? 1 + colors + encodedBytes : 0;
+}
\ No newline at end of file
@@ -0,0 +1,113 @@
+// This code is designed to be compiled with GCC.
+// The conversion tool rewrites densely packed images as run-length coded
+// images. It is executed as follows:
+//     convert.exe <input> <output> [pixels per image]
+// The input file holds one image, or several images stored one after the
+// other, like texture maps, if the pixel count of every image is passed.
+// Otherwise, every color code of the single image is converted, including
+// codes padding its last byte. The tool prints the size of both files.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "encode.h"
+
+/*
+ * This section establishes and outlines function symbols used thoughout
+ * this program.
+ */
+
+/*
+ * The function below is the entry point to the conversion tool. It reads
+ * every image of the input file in sequence, and writes its run-length coded
+ * counterpart to the output file.
+ */
+
+int main(int argc, char** argv) {
+
+    if (argc < 3) {
+        fprintf(stderr, "Usage: %s <input> <output> [pixels per image]\n",
+            argv[0]);
+        return EXIT_FAILURE;
+    }
+    const uint32_t imagePixels = argc > 3 ? strtoul(argv[3], NULL, 10) : 0;
+
+    uint32_t inputSize;
+    uint8_t* const pInput = readFile(argv[1], &inputSize);
+    if (pInput == NULL) {
+        fprintf(stderr, "Image file %s could not be read.\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+    FILE* const pFile = fopen(argv[2], "wb");
+    if (pFile == NULL) {
+        fprintf(stderr, "Image file %s could not be created.\n", argv[2]);
+        free(pInput);
+        return EXIT_FAILURE;
+    }
+
+    uint32_t offset = 0;
+    uint32_t outputSize = 0;
+    uint32_t images = 0;
+    uint8_t colors, colorCodeBits, remainingCodes;
+    uint32_t pixels, encodedBytes, encodedImageSize;
+    uint8_t* pOutput;
+    while (offset < inputSize) {
+        colors = pInput[offset++];
+        if (colors == RUN_LENGTH_MARKER) {
+            fprintf(stderr, "Image %u of %s is already run-length coded.\n",
+                images, argv[1]);
+            break;
+        }
+        if (inputSize - offset < colors) {
+            fprintf(stderr, "Image %u of %s is truncated.\n", images,
+                argv[1]);
+            break;
+        }
+        // Color codes are as long as the number of bits required to
+        // describe the highest color code.
+        remainingCodes = colors - 1;
+        colorCodeBits = 0;
+        do {
+            colorCodeBits++;
+        } while (remainingCodes >>= 1);
+        encodedBytes = inputSize - offset - colors;
+        pixels = encodedBytes * 8 / colorCodeBits;
+        if (imagePixels > 0) {
+            pixels = imagePixels;
+            encodedBytes = (pixels * colorCodeBits + 7) / 8;
+            if (inputSize - offset - colors < encodedBytes) {
+                fprintf(stderr, "Image %u of %s is truncated.\n", images,
+                    argv[1]);
+                break;
+            }
+        }
+
+        pOutput = malloc(boundRunLengthImage(colors, pixels));
+        if (pOutput == NULL) {
+            fprintf(stderr, "Memory allocation failed.\n");
+            break;
+        }
+        encodedImageSize = encodeRunLengthImage(colors, colorCodeBits,
+            pixels, pInput + offset, pInput + offset + colors, pOutput);
+        fwrite(pOutput, 1, encodedImageSize, pFile);
+        free(pOutput);
+        outputSize += encodedImageSize;
+        offset += colors + encodedBytes;
+        images++;
+    }
+    free(pInput);
+
+    if (fclose(pFile) != 0 || offset < inputSize) {
+        fprintf(stderr, "Image file %s could not be converted.\n",
+            argv[1]);
+        remove(argv[2]);
+        return EXIT_FAILURE;
+    }
+    printf("Converted %u images of %s (%u bytes) to %s (%u bytes, %u%%).\n",
+        images, argv[1], inputSize, argv[2], outputSize,
+        inputSize > 0 ? (uint32_t) ((uint64_t) outputSize * 100 / inputSize)
+        : 0);
+    return EXIT_SUCCESS;
+}
@@ -26,13 +26,13 @@ enum {
 
 #define DEBUG_CHAR_HEIGHT 14
 #define DEBUG_CHAR_WIDTH 11
-#define DEBUG_METRICS_LINE_SIZE 6
+#define DEBUG_METRICS_LINE_SIZE 10
 #define MAX_DEBUG_MESSAGE_SIZE (BACKBUFFER_WIDTH / DEBUG_CHAR_WIDTH)
 #define MAX_DEBUG_MESSAGE_NUMBER (BACKBUFFER_HEIGHT / DEBUG_CHAR_HEIGHT - DEBUG_METRICS_LINE_SIZE)
 
 #define MAX_CHARACTER_NUM 8
 
-#define panic(str) MessageBox(NULL, str, "An unexpected error has occured.", MB_ICONEXCLAMATION | MB_OK); PostQuitMessage(0);
+#define panic(str) reportPanic(str)
 
 #define TRUE 1
 #define FALSE 0
@@ -57,6 +57,17 @@ typedef struct {
     UINT16 y;
 } sPosition;
 
+// The struct below describes a rectangle of pixels by the columns of its
+// left and right edges and by the rows of its bottom and top edges. The
+// left column and the bottom row belong to the rectangle, whereas the
+// right column and the top row do not.
+typedef struct {
+    UINT16 left;
+    UINT16 bottom;
+    UINT16 right;
+    UINT16 top;
+} sRect;
+
 // The struct below is intended to describe vertical and horizontal
 // velocities of objects bearing these motions.
 typedef struct {
@@ -93,7 +104,10 @@ typedef union {
 // this program. This struct is comprised of a collision width and
 // height, as well as a maximum horizontal speed and a number of unique
 // animation frames that the pixel data associated to the mold is intended 
-// to describe.
+// to describe. The pixel data is kept encoded. Its memory holds the palette
+// of the mold followed by the encoded color codes of all frames, or by the
+// run stream of all frames if the graphics are run-length coded. Frames are
+// decoded in the atlas when first rendered.
 typedef struct {
     union {
         struct {
@@ -103,7 +117,11 @@ typedef struct {
         };
         UINT32 moldInfo;
     };
-    sPixel* pPixelData;
+    UINT8 colors;
+    UINT8 colorCodeBits;
+    UINT32 encodedPixelDataBytes;
+    BYTE* pEncodedData;
+    BOOLEAN isRunLength;
 } sMold;
 
 // The struct below aims to have all information required for rendering a
@@ -147,6 +165,19 @@ typedef struct {
     BYTE* pTilemap;
 } sLevelInfo;
 
+// The struct below is a snapshot of the keyboard taken by the platform
+// before every game update. Keys controlling the player are down while
+// held, whereas the control key is the letter pressed along the control key
+// since the previous snapshot, or zero.
+typedef struct {
+    BOOLEAN isLeftDown;
+    BOOLEAN isRightDown;
+    BOOLEAN isJumpDown;
+    BOOLEAN isRunDown;
+    BOOLEAN isInFocus;
+    CHAR controlKey;
+} sInput;
+
 /*
  * The following function definitions apply for functions intended to have
  * global use in any part of the application.
@@ -154,6 +185,8 @@ typedef struct {
 
  __cdecl void debugPrintf(const CHAR* string, ...);
 
+__forceinline void reportPanic(const CHAR* const restrict string);
+
 /*
  * The variables below are used by dispersed files and used to share
  * information between each other.
@@ -168,9 +201,6 @@ sMold gCharacterMolds[CHARACTER_VARIETY];
 // The struct instance "gMutableCharacterArray" stores all references to characters
 // loaded in the current level.
 sCharacterArray gMutableCharacterArray;
-// The array labeled "gTile" is intended to store a pointer to the tile
-// texture altas.
-sPixel gTileAtlas[TILE_VARIETY][TILE_SIZE * TILE_SIZE];
 // The "gBackbuffer" variable stores the address of the backbuffer for
 // rendering any graphic. This backbuffer's pixel data is then rendered
 // on the application window's pixel data.
@@ -191,6 +221,11 @@ BOOLEAN gIsDebug = FALSE;
 // of this program may change data in it.
 sRenderInfo gRenderInfo = {0};
 
+// The variable below is only set on threads running tasks concurrently. It
+// points to where the first panic message of the running task is saved,
+// for the thread that started the task to report it instead.
+_Thread_local const CHAR** gpDeferredPanicMessage = NULL;
+
 // Variable only used in the function below.
 CHAR* pOldestMessage;
 
@@ -220,5 +255,24 @@ __cdecl void debugPrintf(const CHAR* restrict string, ...) {
         args);
     va_end(args);
     
+    return;
+}
+
+/*
+ * The "reportPanic" function displays an error message and requests the
+ * application to quit. The message is only saved if the calling thread runs
+ * a task concurrently with others.
+ */
+
+__forceinline void reportPanic(const CHAR* const restrict string) {
+    if (gpDeferredPanicMessage != NULL) {
+        if (*gpDeferredPanicMessage == NULL) {
+            *gpDeferredPanicMessage = string;
+        }
+        return;
+    }
+    MessageBox(NULL, string, "An unexpected error has occured.",
+        MB_ICONEXCLAMATION | MB_OK);
+    PostQuitMessage(0);
     return;
 }
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cpuid.h>
+
+/*
+ * This file determines which vector instruction set extensions the
+ * processor running this application supports. Procedures featuring
+ * vectorized variants select them as a function of the "gSimdLevel"
+ * variable. Such procedures must always feature a scalar counterpart.
+ */
+
+enum {
+    simdNone,
+    simdSsse3,
+    simdAvx2,
+};
+
+__forceinline void initSimdLevel();
+
+// The variable below describes the most capable instruction set extension
+// that the processor and the operating system both support. It is set
+// exactly once, prior to any initialization procedure that may read it.
+UINT8 gSimdLevel = simdNone;
+
+/*
+ * The "initSimdLevel" function queries the processor through the "cpuid"
+ * instruction. The AVX2 extension additionally requires the operating system
+ * to save the upper halves of vector registers on context switches. This
+ * requirement is confirmed by reading the extended control register.
+ */
+
+__forceinline void initSimdLevel() {
+
+    UINT32 eax, ebx, ecx, edx;
+
+    gSimdLevel = simdNone;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0
+            || (ecx & bit_SSSE3) == 0) {
+        return;
+    }
+    gSimdLevel = simdSsse3;
+
+    // The "OSXSAVE" bit indicates that the "xgetbv" instruction may be
+    // executed at all.
+    if ((ecx & bit_OSXSAVE) == 0 || (ecx & bit_AVX) == 0) {
+        return;
+    }
+    UINT32 xcrLow, xcrHigh;
+    __asm__ ("xgetbv" : "=a" (xcrLow), "=d" (xcrHigh) : "c" (0));
+    // Both the SSE and AVX register states must be enabled.
+    if ((xcrLow & 0x06) != 0x06) {
+        return;
+    }
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0
+            || (ebx & bit_AVX2) == 0) {
+        return;
+    }
+    gSimdLevel = simdAvx2;
+    return;
+}
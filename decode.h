@@ -1,109 +1,804 @@
 #pragma once
 
+#include <immintrin.h>
+
 #include "prop_render.h"
+#include "prop_image.h"
+#include "cpu.h"
+#include "read.h"
+#include "task.h"
+
+// Color codes of at most this many bits are decoded by vectorized kernels
+// when the processor supports them. Such codes describe at most 16 colors,
+// which fit in a single vector register per color channel.
+#define DECODE_SIMD_MAX_CODE_BITS 4
+
+// Images are decoded by as many workers as there are whole multiples of the
+// pixel count below in them. Images smaller than two such multiples are
+// decoded by the calling thread alone, since starting threads would take
+// longer than decoding them.
+#define DECODE_MIN_PIXELS_PER_WORKER 65536
+// Chunks of an image decoded concurrently start at a multiple of the pixel
+// count below. Any multiple of eight codes starts on a byte boundary,
+// whatever the code length. A multiple of 64 codes also keeps vectorized
+// kernels from leaving codes to the scalar kernels in every chunk.
+#define DECODE_CHUNK_ALIGNMENT_PIXELS 64
+
+// The struct below describes a chunk of an image decoded by a worker. Its
+// members are the arguments of the "decodePixelDataFeaturing" function.
+typedef struct {
+    const BYTE* pPaletteDataBuffer;
+    const BYTE* pPixelDataBuffer;
+    sPixel* pDestination;
+    UINT32 encodedPixelDataPixels;
+    UINT32 encodedPixelDataBytes;
+    UINT8 colors;
+    UINT8 colorCodeBits;
+} sDecodeChunk;
 
 /*
  * The code section below outline all functions used throughout this file.
  */
 
 __forceinline void decodePixelDataFeaturing(
-    const UINT8 colors, 
+    const UINT8 colors,
+    const UINT8 colorCodeBits,
+    const UINT32 encodedPixelDataPixels,
+    const UINT32 encodedPixelDataBytes,
+    const BYTE* const restrict pPaletteDataBuffer,
+    const BYTE* const restrict pPixelDataBuffer,
+    sPixel* const restrict pDestination);
+
+__forceinline void decodePixelDataConcurrently(
+    UINT8 workers,
+    const UINT8 colors,
     const UINT8 colorCodeBits,
+    const UINT32 encodedPixelDataPixels,
     const UINT32 encodedPixelDataBytes,
-    const BYTE* const restrict pPaletteDataBuffer, 
-    sPixel* const restrict pCodeToPixelBuffer, 
+    const BYTE* const restrict pPaletteDataBuffer,
     const BYTE* const restrict pPixelDataBuffer,
     sPixel* const restrict pDestination);
 
+LRESULT decodeChunkTask(void* pChunk);
+
+__forceinline void decodeImage(
+    const UINT8 workers,
+    const sEncodedImage* const restrict pImage,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+__forceinline void decodeRunLengthPixelData(
+    const UINT8 colors,
+    const UINT8 colorCodeBits,
+    UINT32 skippedPixels,
+    const UINT32 pixels,
+    const UINT32 runStreamBytes,
+    const BYTE* const restrict pPaletteDataBuffer,
+    const BYTE* const restrict pRunStream,
+    sPixel* const restrict pDestination);
+
+__forceinline void decodeColorCodes(
+    const UINT8 colorCodeBits,
+    UINT32 pixels,
+    UINT32 bytes,
+    const sPixel* const restrict pCodeToPixelBuffer,
+    const BYTE* restrict pPixelDataBuffer,
+    sPixel* restrict pDestination);
+
+UINT32 decodeColorCodesSsse3(
+    const UINT8 colors,
+    const UINT8 colorCodeBits,
+    const UINT32 pixels,
+    const UINT32 bytes,
+    const sPixel* const restrict pCodeToPixelBuffer,
+    const BYTE* const restrict pPixelDataBuffer,
+    sPixel* const restrict pDestination);
+
+UINT32 decodeColorCodesAvx2(
+    const UINT8 colors,
+    const UINT8 colorCodeBits,
+    const UINT32 pixels,
+    const UINT32 bytes,
+    const sPixel* const restrict pCodeToPixelBuffer,
+    const BYTE* const restrict pPixelDataBuffer,
+    sPixel* const restrict pDestination);
+
+__forceinline void indexPixels(
+    const sPixel* const restrict pPixels,
+    const UINT32 pixels,
+    UINT8* const restrict pIndexedPixels);
+
+/*
+ * The table below maps every 8-bit color of a palette header to its pixel.
+ * Palette colors are packed as three bits of red, three bits of green and
+ * two bits of blue, from the most to the least significant bit. The table is
+ * generated at compile time such that decoding a palette is a single lookup
+ * per color.
+ */
+
+#define expand332(color) {.whole = (((color) & 0xE0) << 16) \
+    | ((((color) >> 2) & 0x07) << 13) \
+    | (((color) & 0x03) << 6)}
+#define expand332Row(high) \
+    expand332((high) + 0x0), expand332((high) + 0x1), \
+    expand332((high) + 0x2), expand332((high) + 0x3), \
+    expand332((high) + 0x4), expand332((high) + 0x5), \
+    expand332((high) + 0x6), expand332((high) + 0x7), \
+    expand332((high) + 0x8), expand332((high) + 0x9), \
+    expand332((high) + 0xA), expand332((high) + 0xB), \
+    expand332((high) + 0xC), expand332((high) + 0xD), \
+    expand332((high) + 0xE), expand332((high) + 0xF)
+
+const sPixel gColor332ToPixel[256] = {
+    expand332Row(0x00), expand332Row(0x10),
+    expand332Row(0x20), expand332Row(0x30),
+    expand332Row(0x40), expand332Row(0x50),
+    expand332Row(0x60), expand332Row(0x70),
+    expand332Row(0x80), expand332Row(0x90),
+    expand332Row(0xA0), expand332Row(0xB0),
+    expand332Row(0xC0), expand332Row(0xD0),
+    expand332Row(0xE0), expand332Row(0xF0)
+};
+
+#undef expand332Row
+#undef expand332
+
+/*
+ * The "indexPixels" function writes the 3-3-2 color of every passed pixel,
+ * which the table above maps back to the pixel. Decoded pixels are always
+ * expanded from such colors, such that none of their bits is lost. The
+ * transparent color is indexed as the transparent palette color.
+ */
+
+__forceinline void indexPixels(
+        const sPixel* const restrict pPixels,
+        const UINT32 pixels,
+        UINT8* const restrict pIndexedPixels) {
+
+    for (UINT32 i = 0; i < pixels; i++) {
+        pIndexedPixels[i] = (pPixels[i].red & 0xE0)
+            | (pPixels[i].green >> 5 << 2)
+            | pPixels[i].blue >> 6;
+    }
+    return;
+}
+
 /*
  * The call to the function defined below decocdes raw pixel data given
  * arguments that are as follows:
  * - a color count
  * - the amount of bits needed to represent a color code
  * - the number of pixels in the image pixel data
- * - a pointer to hold raw palette data
- * - a pointer to a color code-to-pixel mapping
- * - a pointer to hold raw palette data
- * - a pointer to allocated memory where decoded data is written to. 
- * This function does not manipulate any memory or its allocation.
+ * - the number of bytes in the encoded pixel data
+ * - a pointer to raw palette data
+ * - a pointer to raw pixel data
+ * - a pointer to allocated memory where decoded data is written to.
+ * This function does not manipulate any memory or its allocation. Exactly
+ * as many pixels as the pixel count argument describes are written. Images
+ * of at most 16 colors are first decoded by a vectorized kernel if the
+ * processor supports one. Any pixel this kernel leaves undecoded is decoded
+ * by the scalar kernels.
  */
 
+// Every supported color code length is given its own case below. The bit
+// count passed to the kernel is a litteral in each case, which lets the
+// compiler fold all shifts and masks of that kernel into constants.
+#define decodeKernelCaseOf(bits) \
+    case bits: \
+    decodeColorCodes(bits, \
+        encodedPixelDataPixels - decodedPixels, \
+        encodedPixelDataBytes - decodedBytes, \
+        pCodeToPixelBuffer, \
+        pPixelDataBuffer + decodedBytes, \
+        pDestination + decodedPixels); \
+    break;
+
 __forceinline void decodePixelDataFeaturing(
         const UINT8 colors,
         const UINT8 colorCodeBits,
-        const UINT32 encodedPixelDataBytes, 
-        const BYTE* const restrict pPaletteDataBuffer, 
-        sPixel* const restrict pCodeToPixelBuffer,
+        const UINT32 encodedPixelDataPixels,
+        const UINT32 encodedPixelDataBytes,
+        const BYTE* const restrict pPaletteDataBuffer,
         const BYTE* const restrict pPixelDataBuffer,
         sPixel* const restrict pDestination) {
-    
-    UINT8 extracted8bitPixel;
-    for (UINT8 i = 0; i < colors; i++) {
-        pCodeToPixelBuffer[i].alpha = 0;
-        // The command below saves the next byte, which certainly
-        // is an entire 8-bit color, by assigning it to a variable.
-        extracted8bitPixel = pPaletteDataBuffer[i];
-        pCodeToPixelBuffer[i].blue = (extracted8bitPixel & 0x03) << 6;
-        extracted8bitPixel >>= 2;
-        pCodeToPixelBuffer[i].green = (extracted8bitPixel & 0x07) << 5;
-        extracted8bitPixel >>= 3;
-        pCodeToPixelBuffer[i].red = extracted8bitPixel << 5;            
-    }
-    
-    union {
-        struct {
-            BYTE low;
-            BYTE high;
-        };
-        UINT16 whole;
-    } parsedBits = {0};
-    UINT8 bitsToRead = sizeof(pPixelDataBuffer[0]) * 8;
-    UINT8 colorCodeBitmask = (1 << colorCodeBits) - 1;
-    UINT8 bitOffset = colorCodeBits;
-    UINT8 bitsToReadForNextIter;
-    // The maximum size of a ".bci" formatted image is unknown. This format
-    // lacks pixel width and height.
-    UINT32 pixelsWritten = 0;
-    for (UINT32 readBytes = 0; 
-            readBytes < encodedPixelDataBytes; 
-            readBytes++) {
-        parsedBits.low = pPixelDataBuffer[readBytes];
-        for (; bitOffset <= bitsToRead; bitOffset += colorCodeBits) {
-            pDestination[pixelsWritten] = pCodeToPixelBuffer[
-                (parsedBits.whole >> (bitsToRead - bitOffset))
+
+    // The color code-to-pixel mapping holds as many entries as a color code
+    // of at most eight bits can index.
+    sPixel pCodeToPixelBuffer[256];
+    for (UINT16 i = 0; i < colors; i++) {
+        pCodeToPixelBuffer[i] = gColor332ToPixel[pPaletteDataBuffer[i]];
+    }
+
+    UINT32 decodedPixels = 0;
+    if (colorCodeBits <= DECODE_SIMD_MAX_CODE_BITS) {
+        switch(gSimdLevel) {
+            case simdAvx2:
+
+            decodedPixels = decodeColorCodesAvx2(
+                colors,
+                colorCodeBits,
+                encodedPixelDataPixels,
+                encodedPixelDataBytes,
+                pCodeToPixelBuffer,
+                pPixelDataBuffer,
+                pDestination);
+            break;
+
+            case simdSsse3:
+
+            decodedPixels = decodeColorCodesSsse3(
+                colors,
+                colorCodeBits,
+                encodedPixelDataPixels,
+                encodedPixelDataBytes,
+                pCodeToPixelBuffer,
+                pPixelDataBuffer,
+                pDestination);
+            break;
+
+            default:
+
+            break;
+        }
+    }
+    // Vectorized kernels only decode whole groups of eight codes, such that
+    // the remaining codes start on a byte boundary.
+    const UINT32 decodedBytes = decodedPixels * colorCodeBits / 8;
+
+    switch(colorCodeBits) {
+        decodeKernelCaseOf(1)
+        decodeKernelCaseOf(2)
+        decodeKernelCaseOf(3)
+        decodeKernelCaseOf(4)
+        decodeKernelCaseOf(5)
+        decodeKernelCaseOf(6)
+        decodeKernelCaseOf(7)
+        decodeKernelCaseOf(8)
+
+        default:
+        // Palettes feature at most 256 colors. No other color code length
+        // can be produced by the image reading procedure.
+        break;
+    }
+    return;
+}
+
+#undef decodeKernelCaseOf
+
+/*
+ * The "decodePixelDataConcurrently" function decodes an image like the
+ * "decodePixelDataFeaturing" function, but splits it in chunks decoded by
+ * at most the passed number of workers. Every chunk starts on a byte
+ * boundary of the encoded pixel data, such that each is decoded on its own
+ * straight into its region of the destination. Small images are decoded by
+ * the calling thread alone.
+ */
+
+__forceinline void decodePixelDataConcurrently(
+        UINT8 workers,
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        const UINT32 encodedPixelDataPixels,
+        const UINT32 encodedPixelDataBytes,
+        const BYTE* const restrict pPaletteDataBuffer,
+        const BYTE* const restrict pPixelDataBuffer,
+        sPixel* const restrict pDestination) {
+
+    if (encodedPixelDataPixels / DECODE_MIN_PIXELS_PER_WORKER < workers) {
+        workers = encodedPixelDataPixels / DECODE_MIN_PIXELS_PER_WORKER;
+    }
+    if (workers > TASK_MAX_WORKERS) {
+        workers = TASK_MAX_WORKERS;
+    }
+    if (workers <= 1) {
+        decodePixelDataFeaturing(
+            colors,
+            colorCodeBits,
+            encodedPixelDataPixels,
+            encodedPixelDataBytes,
+            pPaletteDataBuffer,
+            pPixelDataBuffer,
+            pDestination);
+        return;
+    }
+
+    // Every chunk but the last one holds the pixel count below.
+    const UINT32 chunkPixels = (encodedPixelDataPixels / workers
+        + DECODE_CHUNK_ALIGNMENT_PIXELS - 1)
+        / DECODE_CHUNK_ALIGNMENT_PIXELS * DECODE_CHUNK_ALIGNMENT_PIXELS;
+    sDecodeChunk chunks[TASK_MAX_WORKERS];
+    sTask tasks[TASK_MAX_WORKERS];
+    UINT8 chunkNumber = 0;
+    UINT32 startPixel, startByte;
+    for (; chunkNumber < workers; chunkNumber++) {
+        startPixel = chunkNumber * chunkPixels;
+        if (startPixel >= encodedPixelDataPixels) {
+            break;
+        }
+        startByte = startPixel / 8 * colorCodeBits;
+        chunks[chunkNumber] = (sDecodeChunk) {
+            pPaletteDataBuffer,
+            pPixelDataBuffer + startByte,
+            pDestination + startPixel,
+            chunkPixels,
+            chunkPixels / 8 * colorCodeBits,
+            colors,
+            colorCodeBits};
+        tasks[chunkNumber] = (sTask) {decodeChunkTask, &chunks[chunkNumber],
+            "Decode", NULL, ERROR_SUCCESS, 0};
+    }
+    // The last chunk holds the remaining pixels and encoded bytes, whose
+    // last byte may be partially used.
+    sDecodeChunk* const pLastChunk = &chunks[chunkNumber - 1];
+    startPixel = (chunkNumber - 1) * chunkPixels;
+    pLastChunk->encodedPixelDataPixels = encodedPixelDataPixels - startPixel;
+    pLastChunk->encodedPixelDataBytes = encodedPixelDataBytes
+        - startPixel / 8 * colorCodeBits;
+    runTasks(tasks, chunkNumber, chunkNumber);
+    return;
+}
+
+/*
+ * The "decodeChunkTask" function decodes the chunk of an image passed as
+ * the argument of its task. It never fails.
+ */
+
+LRESULT decodeChunkTask(void* pChunk) {
+
+    const sDecodeChunk* const pDecodeChunk = pChunk;
+    decodePixelDataFeaturing(
+        pDecodeChunk->colors,
+        pDecodeChunk->colorCodeBits,
+        pDecodeChunk->encodedPixelDataPixels,
+        pDecodeChunk->encodedPixelDataBytes,
+        pDecodeChunk->pPaletteDataBuffer,
+        pDecodeChunk->pPixelDataBuffer,
+        pDecodeChunk->pDestination);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "decodeImage" function decodes an image read by the "readImage"
+ * function, whatever its format. Densely packed images are decoded by at
+ * most the passed number of workers. Run-length coded images are decoded by
+ * the calling thread, since their runs cannot be located without reading
+ * all runs preceding them.
+ */
+
+__forceinline void decodeImage(
+        const UINT8 workers,
+        const sEncodedImage* const restrict pImage,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+
+    if (pImage->isRunLength) {
+        decodeRunLengthPixelData(
+            pImage->colors,
+            pImage->colorCodeBits,
+            0,
+            pixels,
+            pImage->encodedPixelDataBytes,
+            pImage->pPalette,
+            pImage->pEncodedPixelData,
+            pDestination);
+        return;
+    }
+    decodePixelDataConcurrently(
+        workers,
+        pImage->colors,
+        pImage->colorCodeBits,
+        pixels,
+        pImage->encodedPixelDataBytes,
+        pImage->pPalette,
+        pImage->pEncodedPixelData,
+        pDestination);
+    return;
+}
+
+/*
+ * The "decodeRunLengthPixelData" function decodes the run stream of a
+ * run-length coded image. The passed number of pixels are written to the
+ * destination, after skipping as many pixels of the stream as passed. This
+ * lets a single animation frame be decoded from the stream of all frames.
+ * Transparent runs are filled without any lookup, and repeated runs with a
+ * single lookup. Literal runs are decoded by the scalar kernels. Pixels
+ * past the end of a stream that is too short are left transparent.
+ */
+
+// As with densely packed images, literal runs are decoded by the kernel of
+// their color code length, which is a litteral in each case below.
+#define decodeLiteralCaseOf(bits) \
+    case bits: \
+    decodeColorCodes(bits, \
+        literalPixels, \
+        literalBytes, \
+        pCodeToPixelBuffer, \
+        pRunStream + readBytes, \
+        pLiteralDestination); \
+    break;
+
+__forceinline void decodeRunLengthPixelData(
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        UINT32 skippedPixels,
+        const UINT32 pixels,
+        const UINT32 runStreamBytes,
+        const BYTE* const restrict pPaletteDataBuffer,
+        const BYTE* const restrict pRunStream,
+        sPixel* const restrict pDestination) {
+
+    sPixel pCodeToPixelBuffer[256];
+    for (UINT16 i = 0; i < colors; i++) {
+        pCodeToPixelBuffer[i] = gColor332ToPixel[pPaletteDataBuffer[i]];
+    }
+    const sPixel transparentPixel = {.whole = COLOR_TRANSPARENT};
+    const UINT8 codeMask = (1 << colorCodeBits) - 1;
+    // A literal run that starts among skipped pixels is decoded in the
+    // buffer below, and only its pixels that are not skipped are copied.
+    sPixel literalBuffer[RUN_MAX_LITERAL_PIXELS];
+
+    UINT32 readBytes = 0;
+    UINT32 decodedPixels = 0;
+    UINT32 runPixels, literalBytes, literalPixels, copiedPixels;
+    UINT32 filledPixels;
+    sPixel* pLiteralDestination;
+    sPixel* pFill;
+    __m128i fill;
+    BYTE control;
+    sPixel runPixel;
+    while (decodedPixels < pixels && readBytes < runStreamBytes) {
+        control = pRunStream[readBytes++];
+        if (control & RUN_LITERAL_TYPE_MASK) {
+            runPixels = (control & RUN_LITERAL_LENGTH_MASK) + 1;
+            literalBytes = (runPixels * colorCodeBits + 7) / 8;
+            if (runStreamBytes - readBytes < literalBytes) {
+                break;
+            }
+            if (skippedPixels >= runPixels) {
+                skippedPixels -= runPixels;
+                readBytes += literalBytes;
+                continue;
+            }
+            copiedPixels = runPixels - skippedPixels;
+            if (copiedPixels > pixels - decodedPixels) {
+                copiedPixels = pixels - decodedPixels;
+            }
+            pLiteralDestination = skippedPixels == 0
+                ? pDestination + decodedPixels : literalBuffer;
+            literalPixels = skippedPixels == 0 ? copiedPixels : runPixels;
+            switch(colorCodeBits) {
+                decodeLiteralCaseOf(1)
+                decodeLiteralCaseOf(2)
+                decodeLiteralCaseOf(3)
+                decodeLiteralCaseOf(4)
+                decodeLiteralCaseOf(5)
+                decodeLiteralCaseOf(6)
+                decodeLiteralCaseOf(7)
+                decodeLiteralCaseOf(8)
+
+                default:
+                break;
+            }
+            if (skippedPixels > 0) {
+                memcpy(pDestination + decodedPixels,
+                    literalBuffer + skippedPixels,
+                    copiedPixels * sizeof(sPixel));
+                skippedPixels = 0;
+            }
+            decodedPixels += copiedPixels;
+            readBytes += literalBytes;
+            continue;
+        }
+
+        runPixels = (control & RUN_LENGTH_MASK) + 1;
+        if ((control & RUN_LENGTH_MASK) == RUN_LENGTH_EXTENDED) {
+            if (runStreamBytes - readBytes < 2) {
+                break;
+            }
+            runPixels += pRunStream[readBytes]
+                | (pRunStream[readBytes + 1] << 8);
+            readBytes += 2;
+        }
+        runPixel = transparentPixel;
+        if ((control & RUN_TYPE_MASK) == RUN_TYPE_REPEATED) {
+            if (readBytes == runStreamBytes) {
+                break;
+            }
+            runPixel = pCodeToPixelBuffer[pRunStream[readBytes++]
+                & codeMask];
+        }
+        if (skippedPixels >= runPixels) {
+            skippedPixels -= runPixels;
+            continue;
+        }
+        copiedPixels = runPixels - skippedPixels;
+        if (copiedPixels > pixels - decodedPixels) {
+            copiedPixels = pixels - decodedPixels;
+        }
+        skippedPixels = 0;
+        // Runs are filled four pixels at a time, which matters for the long
+        // transparent runs surrounding sprites.
+        pFill = pDestination + decodedPixels;
+        fill = _mm_set1_epi32(runPixel.whole);
+        filledPixels = 0;
+        for (; filledPixels + 4 <= copiedPixels; filledPixels += 4) {
+            _mm_storeu_si128((__m128i*) (pFill + filledPixels), fill);
+        }
+        for (; filledPixels < copiedPixels; filledPixels++) {
+            pFill[filledPixels] = runPixel;
+        }
+        decodedPixels += copiedPixels;
+    }
+    for (; decodedPixels < pixels; decodedPixels++) {
+        pDestination[decodedPixels] = transparentPixel;
+    }
+    return;
+}
+
+#undef decodeLiteralCaseOf
+
+/*
+ * The "decodeColorCodes" function translates a stream of color codes to
+ * pixels. Color codes are packed from the most to the least significant bit
+ * of every byte, and a code may straddle two bytes. The stream is read 64
+ * bits at a time. Every group of eight codes spans exactly as many bytes as
+ * there are bits in a code, so a 64-bit word always holds a whole number of
+ * such groups. The word is consumed by as many bytes as these groups span,
+ * such that the next word starts on a code boundary.
+ */
+
+__forceinline void decodeColorCodes(
+        const UINT8 colorCodeBits,
+        UINT32 pixels,
+        UINT32 bytes,
+        const sPixel* const restrict pCodeToPixelBuffer,
+        const BYTE* restrict pPixelDataBuffer,
+        sPixel* restrict pDestination) {
+
+    const UINT8 groupsPerWord = 8 / colorCodeBits;
+    const UINT8 codesPerWord = 8 * groupsPerWord;
+    const UINT8 bytesPerWord = colorCodeBits * groupsPerWord;
+    const UINT64 colorCodeBitmask = (1 << colorCodeBits) - 1;
+    UINT64 word;
+
+    // The loop below requires all eight bytes of a word to be readable, even
+    // if not all of them are consumed.
+    while (pixels >= codesPerWord && bytes >= sizeof(word)) {
+        memcpy(&word, pPixelDataBuffer, sizeof(word));
+        // The first byte of the stream must hold the most significant bits
+        // of the word.
+        word = __builtin_bswap64(word);
+        for (UINT8 i = 0; i < codesPerWord; i++) {
+            pDestination[i] = pCodeToPixelBuffer[
+                (word >> (64 - colorCodeBits * (i + 1)))
                 & colorCodeBitmask];
-            pixelsWritten++;
-            
         }
-        bitsToReadForNextIter = bitsToRead % colorCodeBits;
-        
-        // Consider only the first eight bits for iterpretation in the
-        // next iteration, and not any other.
-        parsedBits.high = 0;
-        // The amount of bits to read for the next iteration is intended
-        // to be the eight bits found in the byte alongside any bits not
-        // read in the last parsing, which may only be fully completed in
-        // the next immediate iteration.
-        bitsToRead = 8 + bitsToReadForNextIter;
-        // The left shift below places any remainding bits to be
-        // parsed outside the first eight bits for the next iteration
-        // of the byte translation to pixel data to interpret. The
-        // amount of shifts required for the unparsed bits to be
-        // interpreted in the next iteration is equal to the difference
-        // between the number of bits in a byte, the amount of bits added
-        // for every iteration, and the current bit offset.
-        UINT8 bitmaskForIter;
-        for (bitmaskForIter = 0; bitsToReadForNextIter > 0; 
-                bitsToReadForNextIter--) {
-            bitmaskForIter <<= 1;
-            bitmaskForIter |= 1;
+        pDestination += codesPerWord;
+        pPixelDataBuffer += bytesPerWord;
+        bytes -= bytesPerWord;
+        pixels -= codesPerWord;
+    }
+
+    // The remaining codes are read from a word padded with zeros. This word
+    // never reads beyond the end of the encoded pixel data.
+    UINT8 codesInWord;
+    while (pixels > 0 && bytes > 0) {
+        word = 0;
+        memcpy(&word, pPixelDataBuffer,
+            bytes < sizeof(word) ? bytes : sizeof(word));
+        word = __builtin_bswap64(word);
+        codesInWord = pixels < codesPerWord ? pixels : codesPerWord;
+        for (UINT8 i = 0; i < codesInWord; i++) {
+            pDestination[i] = pCodeToPixelBuffer[
+                (word >> (64 - colorCodeBits * (i + 1)))
+                & colorCodeBitmask];
         }
-        parsedBits.high  = parsedBits.low & bitmaskForIter;
-        // The bit offset must be reset to the color code bit length 
-        // since the bits in the next series of bits to parse 
-        // through must be read starting at the ones of the lowest 
-        // address.
-        bitOffset = colorCodeBits;
+        pDestination += codesInWord;
+        pPixelDataBuffer += bytesPerWord;
+        bytes -= bytes < bytesPerWord ? bytes : bytesPerWord;
+        pixels -= codesInWord;
     }
     return;
-}
\ No newline at end of file
+}
+
+/*
+ * The functions below are the vectorized counterparts of the
+ * "decodeColorCodes" function for codes of at most four bits. Every block of
+ * 16 codes spans exactly twice as many bytes as there are bits in a code.
+ * Each code is isolated in a 16-bit lane holding the two bytes it may
+ * straddle. A byte shuffle gathers these two bytes, a multiplication by a
+ * power of two shifts the code to the top of the lane, and a right shift
+ * brings it back to the bottom. The 16 codes of a block are then used as
+ * indices to shuffle the blue, green, red and alpha channels of the palette,
+ * which are held in one register each. Both functions return the number of
+ * pixels they decoded, which is always a multiple of 16.
+ */
+
+// The function below writes the byte shuffle and multiplier patterns
+// isolating the codes of a block. The first and last eight codes of a
+// block each have their own pattern. It also splits the palette into its
+// four color channels.
+__forceinline void initDecodeBlockPatterns(
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        const sPixel* const restrict pCodeToPixelBuffer,
+        BYTE pShuffle[const restrict static 32],
+        UINT16 pMultiplier[const restrict static 16],
+        BYTE pChannels[const restrict static 4 * 16]) {
+
+    UINT8 bitOffset;
+    for (UINT8 i = 0; i < 16; i++) {
+        bitOffset = colorCodeBits * i;
+        // The byte of the lowest address must become the most significant
+        // byte of the lane.
+        pShuffle[2 * i] = bitOffset / 8 + 1;
+        pShuffle[2 * i + 1] = bitOffset / 8;
+        pMultiplier[i] = 1 << (bitOffset % 8);
+    }
+
+    // Codes beyond the color count are not expected in valid images. Their
+    // channels are cleared rather than left undefined.
+    memset(pChannels, 0x00, 4 * 16);
+    for (UINT8 i = 0; i < colors; i++) {
+        pChannels[i] = pCodeToPixelBuffer[i].blue;
+        pChannels[16 + i] = pCodeToPixelBuffer[i].green;
+        pChannels[32 + i] = pCodeToPixelBuffer[i].red;
+        pChannels[48 + i] = pCodeToPixelBuffer[i].alpha;
+    }
+    return;
+}
+
+__attribute__ ((target("ssse3"))) UINT32 decodeColorCodesSsse3(
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        const UINT32 pixels,
+        const UINT32 bytes,
+        const sPixel* const restrict pCodeToPixelBuffer,
+        const BYTE* const restrict pPixelDataBuffer,
+        sPixel* const restrict pDestination) {
+
+    BYTE shuffle[32];
+    UINT16 multiplier[16];
+    BYTE channels[4 * 16];
+    initDecodeBlockPatterns(colors, colorCodeBits, pCodeToPixelBuffer,
+        shuffle, multiplier, channels);
+
+    const __m128i lowShuffle = _mm_loadu_si128((const __m128i*) shuffle);
+    const __m128i highShuffle = _mm_loadu_si128(
+        (const __m128i*) (shuffle + 16));
+    const __m128i lowMultiplier = _mm_loadu_si128(
+        (const __m128i*) multiplier);
+    const __m128i highMultiplier = _mm_loadu_si128(
+        (const __m128i*) (multiplier + 8));
+    const __m128i shiftCount = _mm_cvtsi32_si128(16 - colorCodeBits);
+    const __m128i blue = _mm_loadu_si128((const __m128i*) channels);
+    const __m128i green = _mm_loadu_si128((const __m128i*) (channels + 16));
+    const __m128i red = _mm_loadu_si128((const __m128i*) (channels + 32));
+    const __m128i alpha = _mm_loadu_si128((const __m128i*) (channels + 48));
+
+    const UINT8 bytesPerBlock = 2 * colorCodeBits;
+    UINT32 decodedPixels = 0;
+    UINT32 readBytes = 0;
+    __m128i encoded, codes, blueGreen, redAlpha;
+    __m128i* pBlock;
+    // Every iteration loads 16 bytes, even if it consumes fewer.
+    while (pixels - decodedPixels >= 16 && bytes - readBytes >= 16) {
+        encoded = _mm_loadu_si128(
+            (const __m128i*) (pPixelDataBuffer + readBytes));
+        codes = _mm_packus_epi16(
+            _mm_srl_epi16(_mm_mullo_epi16(
+                _mm_shuffle_epi8(encoded, lowShuffle),
+                lowMultiplier), shiftCount),
+            _mm_srl_epi16(_mm_mullo_epi16(
+                _mm_shuffle_epi8(encoded, highShuffle),
+                highMultiplier), shiftCount));
+
+        pBlock = (__m128i*) (pDestination + decodedPixels);
+        blueGreen = _mm_unpacklo_epi8(_mm_shuffle_epi8(blue, codes),
+            _mm_shuffle_epi8(green, codes));
+        redAlpha = _mm_unpacklo_epi8(_mm_shuffle_epi8(red, codes),
+            _mm_shuffle_epi8(alpha, codes));
+        _mm_storeu_si128(pBlock, _mm_unpacklo_epi16(blueGreen, redAlpha));
+        _mm_storeu_si128(pBlock + 1, _mm_unpackhi_epi16(blueGreen, redAlpha));
+        blueGreen = _mm_unpackhi_epi8(_mm_shuffle_epi8(blue, codes),
+            _mm_shuffle_epi8(green, codes));
+        redAlpha = _mm_unpackhi_epi8(_mm_shuffle_epi8(red, codes),
+            _mm_shuffle_epi8(alpha, codes));
+        _mm_storeu_si128(pBlock + 2, _mm_unpacklo_epi16(blueGreen, redAlpha));
+        _mm_storeu_si128(pBlock + 3, _mm_unpackhi_epi16(blueGreen, redAlpha));
+
+        decodedPixels += 16;
+        readBytes += bytesPerBlock;
+    }
+    return decodedPixels;
+}
+
+// The AVX2 kernel decodes two blocks per iteration, one in each 128-bit
+// half of its registers. Shuffles and unpacks never cross these halves, so
+// the decoded pixels are reordered across halves before being stored.
+__attribute__ ((target("avx2"))) UINT32 decodeColorCodesAvx2(
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        const UINT32 pixels,
+        const UINT32 bytes,
+        const sPixel* const restrict pCodeToPixelBuffer,
+        const BYTE* const restrict pPixelDataBuffer,
+        sPixel* const restrict pDestination) {
+
+    BYTE shuffle[32];
+    UINT16 multiplier[16];
+    BYTE channels[4 * 16];
+    initDecodeBlockPatterns(colors, colorCodeBits, pCodeToPixelBuffer,
+        shuffle, multiplier, channels);
+
+    const __m256i lowShuffle = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) shuffle));
+    const __m256i highShuffle = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) (shuffle + 16)));
+    const __m256i lowMultiplier = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) multiplier));
+    const __m256i highMultiplier = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) (multiplier + 8)));
+    const __m128i shiftCount = _mm_cvtsi32_si128(16 - colorCodeBits);
+    const __m256i blue = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) channels));
+    const __m256i green = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) (channels + 16)));
+    const __m256i red = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) (channels + 32)));
+    const __m256i alpha = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128((const __m128i*) (channels + 48)));
+
+    const UINT8 bytesPerBlock = 2 * colorCodeBits;
+    UINT32 decodedPixels = 0;
+    UINT32 readBytes = 0;
+    __m256i encoded, codes, blueGreen, redAlpha;
+    __m256i firstQuarter, secondQuarter, thirdQuarter, fourthQuarter;
+    __m256i* pBlock;
+    // The second block of an iteration loads 16 bytes past its start.
+    while (pixels - decodedPixels >= 32
+            && bytes - readBytes >= (UINT32) bytesPerBlock + 16) {
+        encoded = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128(
+                (const __m128i*) (pPixelDataBuffer + readBytes))),
+            _mm_loadu_si128((const __m128i*) (pPixelDataBuffer + readBytes
+                + bytesPerBlock)),
+            1);
+        codes = _mm256_packus_epi16(
+            _mm256_srl_epi16(_mm256_mullo_epi16(
+                _mm256_shuffle_epi8(encoded, lowShuffle),
+                lowMultiplier), shiftCount),
+            _mm256_srl_epi16(_mm256_mullo_epi16(
+                _mm256_shuffle_epi8(encoded, highShuffle),
+                highMultiplier), shiftCount));
+
+        blueGreen = _mm256_unpacklo_epi8(_mm256_shuffle_epi8(blue, codes),
+            _mm256_shuffle_epi8(green, codes));
+        redAlpha = _mm256_unpacklo_epi8(_mm256_shuffle_epi8(red, codes),
+            _mm256_shuffle_epi8(alpha, codes));
+        firstQuarter = _mm256_unpacklo_epi16(blueGreen, redAlpha);
+        secondQuarter = _mm256_unpackhi_epi16(blueGreen, redAlpha);
+        blueGreen = _mm256_unpackhi_epi8(_mm256_shuffle_epi8(blue, codes),
+            _mm256_shuffle_epi8(green, codes));
+        redAlpha = _mm256_unpackhi_epi8(_mm256_shuffle_epi8(red, codes),
+            _mm256_shuffle_epi8(alpha, codes));
+        thirdQuarter = _mm256_unpacklo_epi16(blueGreen, redAlpha);
+        fourthQuarter = _mm256_unpackhi_epi16(blueGreen, redAlpha);
+
+        // The lower halves hold the first block and the upper halves hold
+        // the second block.
+        pBlock = (__m256i*) (pDestination + decodedPixels);
+        _mm256_storeu_si256(pBlock, _mm256_permute2x128_si256(
+            firstQuarter, secondQuarter, 0x20));
+        _mm256_storeu_si256(pBlock + 1, _mm256_permute2x128_si256(
+            thirdQuarter, fourthQuarter, 0x20));
+        _mm256_storeu_si256(pBlock + 2, _mm256_permute2x128_si256(
+            firstQuarter, secondQuarter, 0x31));
+        _mm256_storeu_si256(pBlock + 3, _mm256_permute2x128_si256(
+            thirdQuarter, fourthQuarter, 0x31));
+
+        decodedPixels += 32;
+        readBytes += 2 * bytesPerBlock;
+    }
+    return decodedPixels;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prop_image.h"
+
+/*
+ * The functions of this file encode densely packed images as run-length
+ * coded images. They only use standard integer types, such that the
+ * application, the conversion tool built from "convert.c", the asset
+ * compiler built from "compile.c" and the packing tool built from "pack.c"
+ * can use them. These tools read their input files whole through the
+ * "readFile" function.
+ * Runs of transparent colors and runs of a repeated color are coded as
+ * single runs if this is shorter than packing their color codes. Any other
+ * color codes are packed in literal runs.
+ */
+
+uint8_t* readFile(const char* const restrict pDir, uint32_t* const pSize);
+
+uint32_t boundRunLengthImage(const uint8_t colors, const uint32_t pixels);
+
+uint32_t encodeRunLengthImage(
+    const uint8_t colors,
+    const uint8_t colorCodeBits,
+    const uint32_t pixels,
+    const uint8_t* const restrict pPalette,
+    const uint8_t* const restrict pPackedCodes,
+    uint8_t* const restrict pOutput);
+
+uint8_t readPackedColorCode(
+    const uint8_t* const restrict pPackedCodes,
+    const uint8_t colorCodeBits,
+    const uint32_t index);
+
+void writePackedColorCode(
+    uint8_t* const restrict pPackedCodes,
+    const uint8_t colorCodeBits,
+    const uint32_t index,
+    const uint8_t code);
+
+uint32_t measureRun(
+    const uint8_t colorCodeBits,
+    const uint32_t pixels,
+    const uint8_t* const restrict pPackedCodes,
+    const uint8_t* const restrict pIsTransparent,
+    const uint32_t index,
+    uint8_t* const restrict pRunType);
+
+uint8_t* writeRun(
+    uint8_t* pOutput,
+    const uint8_t runType,
+    const uint32_t runPixels);
+
+/*
+ * The "readFile" function reads the entire contents of the file found at
+ * the passed directory. The contents are allocated memory that the caller
+ * frees. A null address is returned if the file cannot be read.
+ */
+
+uint8_t* readFile(const char* const restrict pDir, uint32_t* const pSize) {
+
+    FILE* const pFile = fopen(pDir, "rb");
+    if (pFile == NULL) {
+        return NULL;
+    }
+    fseek(pFile, 0, SEEK_END);
+    const long size = ftell(pFile);
+    fseek(pFile, 0, SEEK_SET);
+    // An empty file still receives an allocation for it to be freed
+    // uniformly.
+    uint8_t* const pContents = size < 0 ? NULL : malloc(size + 1);
+    if (pContents == NULL
+            || fread(pContents, 1, size, pFile) != (size_t) size) {
+        free(pContents);
+        fclose(pFile);
+        return NULL;
+    }
+    fclose(pFile);
+    *pSize = (uint32_t) size;
+    return pContents;
+}
+
+/*
+ * The "boundRunLengthImage" function returns the size in bytes that the
+ * run-length coded image of the passed color and pixel counts never
+ * exceeds. No pixel costs more than the two bytes of a literal run of a
+ * single 8-bit code.
+ */
+
+uint32_t boundRunLengthImage(const uint8_t colors, const uint32_t pixels) {
+    return RUN_LENGTH_HEADER_BYTES + colors + RUN_LENGTH_STREAM_SIZE_BYTES
+        + 2 * pixels;
+}
+
+/*
+ * The "encodeRunLengthImage" function encodes the packed color codes of an
+ * image, and writes the resulting run-length coded image to the output.
+ * The output must hold at least as many bytes as the "boundRunLengthImage"
+ * function returns. The size of the written image is returned.
+ */
+
+uint32_t encodeRunLengthImage(
+        const uint8_t colors,
+        const uint8_t colorCodeBits,
+        const uint32_t pixels,
+        const uint8_t* const restrict pPalette,
+        const uint8_t* const restrict pPackedCodes,
+        uint8_t* const restrict pOutput) {
+
+    uint8_t isTransparent[256] = {0};
+    for (uint16_t i = 0; i < colors; i++) {
+        isTransparent[i] = pPalette[i] == PALETTE_TRANSPARENT;
+    }
+
+    uint8_t* pWrite = pOutput;
+    *pWrite++ = RUN_LENGTH_MARKER;
+    *pWrite++ = RUN_LENGTH_VERSION;
+    *pWrite++ = colors;
+    memcpy(pWrite, pPalette, colors);
+    pWrite += colors;
+    // The size of the run stream is written once the stream is complete.
+    uint8_t* const pStreamSize = pWrite;
+    pWrite += RUN_LENGTH_STREAM_SIZE_BYTES;
+    uint8_t* const pStream = pWrite;
+
+    uint8_t runType;
+    uint32_t runPixels;
+    uint32_t literalStart, literalPixels;
+    uint8_t code;
+    for (uint32_t index = 0; index < pixels;) {
+        runPixels = measureRun(colorCodeBits, pixels, pPackedCodes,
+            isTransparent, index, &runType);
+        if (runPixels > 0) {
+            pWrite = writeRun(pWrite, runType, runPixels);
+            if (runType == RUN_TYPE_REPEATED) {
+                *pWrite++ = readPackedColorCode(pPackedCodes, colorCodeBits,
+                    index);
+            }
+            index += runPixels;
+            continue;
+        }
+
+        // A literal run ends where a run worth coding on its own starts.
+        literalStart = index;
+        literalPixels = 0;
+        do {
+            index++;
+            literalPixels++;
+        } while (index < pixels && literalPixels < RUN_MAX_LITERAL_PIXELS
+            && measureRun(colorCodeBits, pixels, pPackedCodes,
+                isTransparent, index, &runType) == 0);
+
+        *pWrite++ = RUN_TYPE_LITERAL | (literalPixels - 1);
+        memset(pWrite, 0, (literalPixels * colorCodeBits + 7) / 8);
+        for (uint32_t i = 0; i < literalPixels; i++) {
+            code = readPackedColorCode(pPackedCodes, colorCodeBits,
+                literalStart + i);
+            writePackedColorCode(pWrite, colorCodeBits, i, code);
+        }
+        pWrite += (literalPixels * colorCodeBits + 7) / 8;
+    }
+
+    const uint32_t streamBytes = (uint32_t) (pWrite - pStream);
+    for (uint8_t i = 0; i < RUN_LENGTH_STREAM_SIZE_BYTES; i++) {
+        pStreamSize[i] = (streamBytes >> (8 * i)) & 0xFF;
+    }
+    return (uint32_t) (pWrite - pOutput);
+}
+
+/*
+ * The "readPackedColorCode" function returns the color code of the passed
+ * index in packed color codes.
+ */
+
+uint8_t readPackedColorCode(
+        const uint8_t* const restrict pPackedCodes,
+        const uint8_t colorCodeBits,
+        const uint32_t index) {
+
+    const uint32_t bit = index * colorCodeBits;
+    uint16_t word = pPackedCodes[bit / 8] << 8;
+    // The second byte is only read if the code straddles it.
+    if (bit % 8 + colorCodeBits > 8) {
+        word |= pPackedCodes[bit / 8 + 1];
+    }
+    return (word >> (16 - colorCodeBits - bit % 8))
+        & ((1 << colorCodeBits) - 1);
+}
+
+/*
+ * The "writePackedColorCode" function writes the passed color code at the
+ * passed index of packed color codes. The bits of the code must be cleared
+ * beforehand.
+ */
+
+void writePackedColorCode(
+        uint8_t* const restrict pPackedCodes,
+        const uint8_t colorCodeBits,
+        const uint32_t index,
+        const uint8_t code) {
+
+    // Codes are packed from the most significant bit, and may straddle two
+    // bytes.
+    const uint32_t bit = index * colorCodeBits;
+    const uint16_t shifted = (uint16_t) (code
+        << (16 - colorCodeBits - bit % 8));
+    pPackedCodes[bit / 8] |= shifted >> 8;
+    if ((shifted & 0xFF) != 0) {
+        pPackedCodes[bit / 8 + 1] |= shifted & 0xFF;
+    }
+}
+
+/*
+ * The "measureRun" function returns the pixel count of the transparent or
+ * repeated run starting at the passed index, and saves its type. Zero is
+ * returned if coding the run would not be shorter than packing its codes
+ * in a literal run.
+ */
+
+uint32_t measureRun(
+        const uint8_t colorCodeBits,
+        const uint32_t pixels,
+        const uint8_t* const restrict pPackedCodes,
+        const uint8_t* const restrict pIsTransparent,
+        const uint32_t index,
+        uint8_t* const restrict pRunType) {
+
+    const uint8_t code = readPackedColorCode(pPackedCodes, colorCodeBits,
+        index);
+    uint32_t runPixels = 1;
+    if (pIsTransparent[code]) {
+        while (index + runPixels < pixels && runPixels < RUN_MAX_PIXELS
+                && pIsTransparent[readPackedColorCode(pPackedCodes,
+                colorCodeBits, index + runPixels)]) {
+            runPixels++;
+        }
+        *pRunType = RUN_TYPE_TRANSPARENT;
+        // A transparent run costs its control byte.
+        return runPixels * colorCodeBits > 8 ? runPixels : 0;
+    }
+    while (index + runPixels < pixels && runPixels < RUN_MAX_PIXELS
+            && readPackedColorCode(pPackedCodes, colorCodeBits,
+            index + runPixels) == code) {
+        runPixels++;
+    }
+    *pRunType = RUN_TYPE_REPEATED;
+    // A repeated run costs its control byte and the byte of its code.
+    return runPixels * colorCodeBits > 16 ? runPixels : 0;
+}
+
+/*
+ * The "writeRun" function writes the control byte of a transparent or
+ * repeated run of the passed pixel count, followed by its extended length
+ * if the run is long. The address past the written bytes is returned.
+ */
+
+uint8_t* writeRun(
+        uint8_t* pOutput,
+        const uint8_t runType,
+        const uint32_t runPixels) {
+
+    if (runPixels <= RUN_MAX_SHORT_PIXELS) {
+        *pOutput++ = runType | (runPixels - 1);
+        return pOutput;
+    }
+    const uint32_t extendedPixels = runPixels - RUN_LENGTH_EXTENDED - 1;
+    *pOutput++ = runType | RUN_LENGTH_EXTENDED;
+    *pOutput++ = extendedPixels & 0xFF;
+    *pOutput++ = extendedPixels >> 8;
+    return pOutput;
+}
@@ -0,0 +1,267 @@
+// This code is designed to be compiled with GCC, on platforms other than
+// Windows, whose headers the "posix.h" file stands in for.
+// The headless renderer runs the game without a window, and renders every
+// game update on a backbuffer in memory. It is executed as follows:
+//     headless [<options>] <frames> [<inputs> [<prefix> [<interval>]]]
+// The game is updated and rendered as many times as the passed number of
+// frames, as fast as possible. Every line of the input file lists the keys
+// held during a game update: "L" and "R" for the left and right arrows, "J"
+// for the spacebar, and "X" for the X key. No key is held past the last
+// line, nor at all if the input file is "-". Every frame whose number is a
+// multiple of the interval, which defaults to one, is written as a binary
+// PPM file named after the passed prefix and the number of the frame. The
+// time taken to render every frame is printed in microseconds, such that
+// frames can be compared against golden images and profiled without a
+// display. The debug overlay is not rendered. The options below select the
+// render settings that the debug controls of the application toggle, such
+// that every setting can be compared against the same golden images:
+//     --mode <mode>    renders in the passed render mode, which Ctrl + R
+//                      cycles through, from 0 for layered rendering;
+//     --banded         renders the scene in bands, like Ctrl + B does;
+//     --simd <level>   uses no vector instruction set extension above the
+//                      passed level, from 0 for none, 1 for SSSE3 and 2 for
+//                      AVX2, even if the processor supports one.
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "posix.h"
+#include "coordinator.h"
+#include "cpu.h"
+#include "logic.h"
+#include "management_background.h"
+#include "management_bundle.h"
+#include "management_character.h"
+#include "management_gen.h"
+#include "management_tile.h"
+#include "management_atlas.h"
+#include "managment_level.h"
+#include "snapshot.h"
+#include "render_frame.h"
+#include "task.h"
+
+// Lines of the input file are at most as long as the value below, including
+// their line feed. Longer lines describe several game updates.
+#define HEADLESS_INPUT_SIZE 64
+// Names of written frames are at most as long as the value below.
+#define HEADLESS_PATH_SIZE 256
+
+/*
+ * This section establishes and outlines function symbols used thoughout
+ * this program.
+ */
+
+__forceinline void readInputs(
+    FILE* const restrict pInputs,
+    sInput* const restrict pInput);
+
+__forceinline int writeFrame(
+    const CHAR* const restrict pPrefix,
+    const UINT32 frame,
+    const sPixel* const restrict pPixels);
+
+/*
+ * The function below is the entry point to the headless renderer. It loads
+ * every asset like the application does, then updates and renders the game
+ * frame after frame.
+ */
+
+int main(int argc, char** argv) {
+
+    // Options precede the other arguments, which are counted from the
+    // first argument that is not an option.
+    unsigned long renderMode = renderLayered;
+    unsigned long maxSimdLevel = simdAvx2;
+    BOOLEAN isValid = TRUE;
+    int first = 1;
+    for (; first < argc && strncmp(argv[first], "--", 2) == 0; first++) {
+        if (strcmp(argv[first], "--banded") == 0) {
+            gIsBanded = TRUE;
+        } else if (strcmp(argv[first], "--mode") == 0 && first + 1 < argc) {
+            first++;
+            renderMode = strtoul(argv[first], NULL, 10);
+        } else if (strcmp(argv[first], "--simd") == 0 && first + 1 < argc) {
+            first++;
+            maxSimdLevel = strtoul(argv[first], NULL, 10);
+        } else {
+            isValid = FALSE;
+        }
+    }
+    const int arguments = argc - first;
+    CHAR** const pArguments = argv + first;
+    if (!isValid || arguments < 1 || arguments > 4) {
+        fprintf(stderr, "Usage: %s [--mode <mode>] [--banded] "
+            "[--simd <level>] <frames> [<inputs> [<prefix> "
+            "[<interval>]]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (renderMode >= RENDER_MODE_VARIETY) {
+        fprintf(stderr, "The render mode must be below %u.\n",
+            RENDER_MODE_VARIETY);
+        return EXIT_FAILURE;
+    }
+    gRenderMode = renderMode;
+    UINT32 frames = strtoul(pArguments[0], NULL, 10);
+    const CHAR* const pPrefix = arguments > 2 ? pArguments[2] : NULL;
+    const UINT32 interval = arguments > 3
+        ? strtoul(pArguments[3], NULL, 10) : 1;
+    if (interval == 0) {
+        fprintf(stderr, "The interval must be at least one.\n");
+        return EXIT_FAILURE;
+    }
+    FILE* pInputs = NULL;
+    if (arguments > 1 && strcmp(pArguments[1], "-") != 0) {
+        pInputs = fopen(pArguments[1], "r");
+        if (pInputs == NULL) {
+            fprintf(stderr, "Input file %s could not be read.\n",
+                pArguments[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    // The backbuffer is plain memory, which features the same bottom-up
+    // layout as the device independent bitmap of the application.
+    sPixel* const pBackground = malloc(BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT
+        * sizeof(sPixel));
+    gBackbuffer.pPixelData = calloc(BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT,
+        sizeof(sPixel));
+    gBackbuffer.memorySize = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT
+        * sizeof(sPixel);
+    if (pBackground == NULL || gBackbuffer.pPixelData == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Assets are loaded one after the other, in the order the application
+    // reports their errors.
+    gPlayer.id = player;
+    initSimdLevel();
+    if (gSimdLevel > maxSimdLevel) {
+        gSimdLevel = maxSimdLevel;
+    }
+    int result = EXIT_SUCCESS;
+    if (initBundle() != ERROR_SUCCESS
+            || initLevel() != ERROR_SUCCESS
+            || initActors() != ERROR_SUCCESS
+            || initBackground(pBackground,
+                BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT) != ERROR_SUCCESS
+            || initCharacterMolds() != ERROR_SUCCESS
+            || initTilePixelData() != ERROR_SUCCESS
+            || buildAtlas() != ERROR_SUCCESS) {
+        fprintf(stderr, "Assets could not be loaded.\n");
+        result = EXIT_FAILURE;
+        frames = 0;
+    }
+    freeBundle();
+    startTaskPool(countTaskWorkers(TASK_MAX_WORKERS));
+
+    sSnapshot snapshot;
+    sInput input = {0};
+    input.isInFocus = TRUE;
+    UINT64 start;
+    UINT32 elapsed;
+    UINT64 elapsedSum = 0;
+    UINT32 elapsedMax = 0;
+    UINT32 frame = 1;
+    for (; frame <= frames && !gIsQuitPosted; frame++) {
+        readInputs(pInputs, &input);
+        logic(&input);
+        takeSnapshot(&snapshot);
+        start = queryMicroseconds();
+        renderFrame(&snapshot, pBackground);
+        elapsed = queryMicroseconds() - start;
+        elapsedSum += elapsed;
+        if (elapsed > elapsedMax) {
+            elapsedMax = elapsed;
+        }
+        printf("%u %u\n", frame, elapsed);
+        if (pPrefix != NULL && frame % interval == 0
+                && writeFrame(pPrefix, frame, gBackbuffer.pPixelData) != 0) {
+            fprintf(stderr, "Frame %u could not be written.\n", frame);
+            result = EXIT_FAILURE;
+            break;
+        }
+    }
+    if (frame > 1) {
+        fprintf(stderr, "Rendered %u frames in %llu us, at most %u us.\n",
+            frame - 1, (unsigned long long) elapsedSum, elapsedMax);
+    }
+    if (gIsQuitPosted) {
+        result = EXIT_FAILURE;
+    }
+
+    stopTaskPool();
+    freeTilemap();
+    freeCharactersMolds();
+    freeAtlas();
+    freeActors();
+    free(gBackbuffer.pPixelData);
+    free(pBackground);
+    if (pInputs != NULL) {
+        fclose(pInputs);
+    }
+    return result;
+}
+
+/*
+ * The "readInputs" function reads the keys held during the next game update
+ * from the passed input file, and writes their states in the passed
+ * keyboard snapshot. No key is held once the file ends, or if no file is
+ * passed.
+ */
+
+__forceinline void readInputs(
+        FILE* const restrict pInputs,
+        sInput* const restrict pInput) {
+
+    CHAR line[HEADLESS_INPUT_SIZE] = {0};
+    if (pInputs != NULL && fgets(line, sizeof(line), pInputs) == NULL) {
+        line[0] = '\0';
+    }
+    pInput->isLeftDown = strchr(line, 'L') != NULL;
+    pInput->isRightDown = strchr(line, 'R') != NULL;
+    pInput->isJumpDown = strchr(line, 'J') != NULL;
+    pInput->isRunDown = strchr(line, 'X') != NULL;
+    return;
+}
+
+/*
+ * The "writeFrame" function writes the passed backbuffer pixels as a binary
+ * PPM file named after the passed prefix and frame number. Rows are written
+ * from the top of the screen, such that the file shows the frame upright.
+ * Zero is returned on success.
+ */
+
+__forceinline int writeFrame(
+        const CHAR* const restrict pPrefix,
+        const UINT32 frame,
+        const sPixel* const restrict pPixels) {
+
+    CHAR path[HEADLESS_PATH_SIZE];
+    if (snprintf(path, sizeof(path), "%s%05u.ppm", pPrefix, frame)
+            >= (int) sizeof(path)) {
+        return 1;
+    }
+    FILE* const pFile = fopen(path, "wb");
+    if (pFile == NULL) {
+        return 1;
+    }
+    BYTE row[BACKBUFFER_WIDTH * 3];
+    const sPixel* pRow;
+    int result = fprintf(pFile, "P6\n%u %u\n255\n", BACKBUFFER_WIDTH,
+        BACKBUFFER_HEIGHT) < 0;
+    for (UINT16 y = BACKBUFFER_HEIGHT; y-- > 0 && result == 0;) {
+        pRow = pPixels + y * BACKBUFFER_WIDTH;
+        for (UINT16 x = 0; x < BACKBUFFER_WIDTH; x++) {
+            row[x * 3] = pRow[x].red;
+            row[x * 3 + 1] = pRow[x].green;
+            row[x * 3 + 2] = pRow[x].blue;
+        }
+        result = fwrite(row, sizeof(row), 1, pFile) != 1;
+    }
+    if (fclose(pFile) != 0) {
+        result = 1;
+    }
+    return result;
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "coordinator.h"
 #include "prop_character.h"
 #include "management_gen.h"
+#include "snapshot.h"
 
 #define isOverflowByAtMost(threshold, n) \
     n >= (~(((UINT64) -1) << (sizeof(n) * 8)) - (threshold * (threshold < 0 ? -1 : 1)))
@@ -12,7 +13,11 @@
  * behave.
  */
 
-__forceinline void logic(const BOOLEAN isInFocus);
+__forceinline void logic(const sInput* const restrict pInput);
+
+__forceinline void updateCharacters(const sInput* const restrict pInput);
+
+__forceinline void cullCharacters();
 
 __forceinline void killPlayer();
 
@@ -38,13 +43,26 @@ UINT8 jumpTimer = 0;
 // The variable defined below governs the player character's animations.
 UINT8 playerAnimationCounter = 0;
 
+/*
+ * The "logic" function performs a game update with the passed keyboard
+ * snapshot. Characters are updated first, and those that left the screen
+ * are culled afterwards. The game state is only written by this function,
+ * such that frames can render a snapshot of it concurrently.
+ */
+
+__forceinline void logic(const sInput* const restrict pInput) {
+    updateCharacters(pInput);
+    cullCharacters();
+    return;
+}
+
 /*
  * The function below computes all logic of the game based on the data stored
  * in all the varibles only accessible to this part of the application
  * declared and intialized above.
  */
 
-__forceinline void logic(const BOOLEAN isInFocus) {            
+__forceinline void updateCharacters(const sInput* const restrict pInput) {            
     
     /*
      * The code section below governs the manipulation of the player
@@ -61,11 +79,11 @@ __forceinline void logic(const BOOLEAN isInFocus) {
     directionVector = (gPlayer.velocity.x != 0 
         | (gPlayer.velocity.x >> (sizeof(gPlayer.velocity.x) * 8 - 1)));    
     
-    curMaxPlayerSpeedX = (GetKeyState('X') & 0x80) ? 
+    curMaxPlayerSpeedX = pInput->isRunDown ? 
         gCharacterMolds[player].maxSpeedX
         : gCharacterMolds[player].maxSpeedX / PLAYER_MIN_FULLSPEED_COEF;
     
-    isInputRight = GetKeyState(VK_RIGHT) & 0x80 && isInFocus;
+    isInputRight = pInput->isRightDown && pInput->isInFocus;
     if (isInputRight) {
         if (gPlayer.velocity.x < curMaxPlayerSpeedX) {
             gPlayer.velocity.x += PLAYER_ACCELERATION_NUMERATOR_X;
@@ -73,7 +91,7 @@ __forceinline void logic(const BOOLEAN isInFocus) {
             gPlayer.velocity.x -= PLAYER_ACCELERATION_NUMERATOR_X;
         }
     }
-    if (GetKeyState(VK_LEFT) & 0x80 && isInFocus) {
+    if (pInput->isLeftDown && pInput->isInFocus) {
         if (gPlayer.velocity.x > -curMaxPlayerSpeedX) {
             gPlayer.velocity.x -= PLAYER_ACCELERATION_NUMERATOR_X;
         } else if (gPlayer.velocity.x < -curMaxPlayerSpeedX) {
@@ -84,7 +102,7 @@ __forceinline void logic(const BOOLEAN isInFocus) {
             PLAYER_ACCELERATION_NUMERATOR_X;
     }
     
-    isInputingJump = GetKeyState(VK_SPACE) & 0x80 && isInFocus;
+    isInputingJump = pInput->isJumpDown && pInput->isInFocus;
     if (wasJumpNotReleased) {
         if (isInputingJump && (jumpTimer < PLAYER_MAX_JUMP_HOLD_FRAMES)) {
             // The logic below triggers if the player inputted the jump
@@ -344,6 +362,10 @@ __forceinline void logic(const BOOLEAN isInFocus) {
         
         pCharacter = &(gMutableCharacterArray.pCharacter[0]) + instanceId;
         characterId = pCharacter->id;
+        // Characters of a null id have no mold, and no behavior.
+        if (characterId == idNull) {
+            continue;
+        }
         mold = gCharacterMolds[characterId];
         switch(characterId) {
             
@@ -489,6 +511,67 @@ __forceinline void logic(const BOOLEAN isInFocus) {
     return;
 }
 
+/*
+ * The "cullCharacters" function suspends the behavior of character
+ * instances outside of the screen that the camera of the current game state
+ * shows. Defeated characters outside of the screen cease all behavior.
+ */
+
+__forceinline void cullCharacters() {
+
+    const UINT16 cameraLeftPosX = placeCamera(&gPlayer).leftPosX;
+    const UINT16 cameraRightPosX = cameraLeftPosX + BACKBUFFER_WIDTH;
+    
+    sCharacter* pCharacter;
+    UINT16 characterLeftPosX;
+    UINT16 characterRightPosX;
+    for (UINT8 instanceId = 0; 
+            instanceId < gMutableCharacterArray.instances; 
+            instanceId++) {
+        
+        pCharacter = &gMutableCharacterArray.pCharacter[instanceId];
+        if (pCharacter->id == idNull) {
+            continue;
+        }
+        characterLeftPosX = pCharacter->pos.x;
+        characterRightPosX = characterLeftPosX 
+            + gCharacterMolds[pCharacter->id].collision.width;
+        if (characterRightPosX > cameraLeftPosX
+                && characterLeftPosX < cameraRightPosX) {
+            continue;
+        }
+        switch(pCharacter->id) {
+            
+            case bug:
+            
+            switch(pCharacter->animState) {
+                
+                case 2: case -3:
+                // Setting the id of this character to null ceases
+                // all of its behavior. This case is triggered when
+                // this character is in its defeat state.
+                pCharacter->id = idNull;
+                break;
+                
+                default:
+                // This case suspends the behavior of the character
+                // until it appears on-screen again.
+                pCharacter->animState = pCharacter->animState >= 0 ?  
+                    ANIM_OFFSCREEN : ~ANIM_OFFSCREEN;
+                break;
+            }
+            break;
+            
+            default:
+            // This point is reached if a character's id is unknown.
+            // The character carries out its behavior whether 
+            // on-screen or off-screen.
+            break;
+        }
+    }
+    return;
+}
+
 /*
  * The "killPlayer" function resets all characters, including the player, to
  * their original states. These states describe position, velocity,
@@ -0,0 +1,362 @@
+#pragma once
+
+#include "coordinator.h"
+#include "decode.h"
+#include "management_span.h"
+#include "management_tile.h"
+#include "management_frame.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/*
+ * The functions of this file build the atlas, which holds the images of
+ * every tile and a bounded number of frame slots in a single allocation of
+ * whole pages. The atlas starts with the table of its images, whose tiles
+ * come first, in the order of their identifiers, and are followed by the
+ * frames of every mold, in the order of the molds. Every image holds its
+ * 3-3-2 colors, then its span lists, and starts on a cache line, such that
+ * its first rows share no line with another image. Tiles are packed once
+ * the atlas is built, whereas character molds keep their pixel data
+ * encoded, and each of their frames is decoded in a slot when it is
+ * fetched and not in any slot. Once every slot is used, the frame of the
+ * least recently fetched slot is evicted to make room for the next one.
+ * Decoded frames thus take as much memory as the slots at most, and pages
+ * of slots never used are not made resident by the system. The whole atlas
+ * is released by a single call.
+ */
+
+// Images of the atlas start on a boundary of the size below, which is the
+// size of a cache line.
+#define ATLAS_ALIGNMENT 64
+
+// The number of frame slots must be at least the number of distinct frames
+// that are fetched before any of them is rendered. Frames on screen beyond
+// it remain correct, but are decoded again every game update.
+#define ATLAS_FRAME_SLOTS 16
+
+// The macro below rounds a number of bytes up to the alignment of images.
+#define alignAtlasBytes(bytes) \
+    (((bytes) + ATLAS_ALIGNMENT - 1) & ~(UINT32) (ATLAS_ALIGNMENT - 1))
+
+// The struct below describes a frame slot of the atlas. The "lastUse"
+// member is the value of the clock of the atlas when the frame it holds
+// was last fetched, or zero if it holds none. The frame is the image of the
+// table of the atlas at the index below, followed by its mirrored
+// counterpart.
+typedef struct {
+    UINT32 lastUse;
+    UINT16 image;
+} sAtlasSlot;
+
+// The struct below describes the atlas. Its memory holds the table of its
+// images, whether each image is decoded and the slot of every decoded
+// frame, followed by the tiles and by the frame slots. The frames of a mold
+// start at the index of the table that "moldImages" features for this
+// mold, and every frame is followed by its mirrored counterpart. Frames
+// are decoded in the buffer of pixels below before their 3-3-2 colors are
+// packed. The hits, misses and evictions are displayed in the debug
+// interface.
+typedef struct {
+    BYTE* pMemory;
+    UINT32 bytes;
+    sSpanImage* pImages;
+    BOOLEAN* pIsDecoded;
+    UINT8* pImageSlots;
+    BYTE* pSlotMemory;
+    UINT32 slotBytes;
+    sPixel* pFramePixels;
+    UINT16 images;
+    UINT16 moldImages[CHARACTER_VARIETY];
+    sAtlasSlot slots[ATLAS_FRAME_SLOTS];
+    UINT8 slotNumber;
+    UINT32 clock;
+    UINT32 frameHits;
+    UINT32 frameMisses;
+    UINT32 frameEvictions;
+} sAtlas;
+
+sAtlas gAtlas = {0};
+
+__forceinline LRESULT buildAtlas();
+
+__forceinline UINT32 measureAtlasImage(
+    const UINT8 width,
+    const UINT8 height);
+
+__forceinline UINT8* placeAtlasImage(
+    BYTE* const restrict pImageMemory,
+    const UINT8 width,
+    const UINT8 height,
+    sSpanImage* const restrict pImage);
+
+__forceinline const sSpanImage* fetchTileImage(const UINT8 tileId);
+
+__forceinline BOOLEAN decodeAtlasFrame(
+    const UINT8 moldId,
+    const UINT8 frame,
+    const UINT16 image,
+    const UINT8 slot);
+
+__forceinline const sSpanImage* fetchMoldFrame(
+    const UINT8 moldId,
+    const UINT8 frame,
+    const BOOLEAN isMirrored);
+
+__forceinline void freeAtlas();
+
+/*
+ * The "buildAtlas" function reserves the tiles and the frame slots of the
+ * atlas, replacing the atlas built before if any, and packs the decoded
+ * tiles. It is called once the tiles and the molds are loaded. Every slot
+ * fits the largest frame of any mold in both orientations, and no more
+ * slots are reserved than there are frames. The decoded tiles are freed
+ * once packed, whereas the molds must remain loaded for as long as their
+ * frames can be fetched.
+ */
+
+__forceinline LRESULT buildAtlas() {
+
+    freeAtlas();
+    UINT16 images = TILE_VARIETY;
+    UINT8 maxWidth = 0;
+    UINT8 maxHeight = 0;
+    const sMold* pMold;
+    for (UINT8 moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {
+        pMold = &gCharacterMolds[moldId];
+        images += 2 * pMold->frames;
+        if (maxWidth < pMold->collision.width) {
+            maxWidth = pMold->collision.width;
+        }
+        if (maxHeight < pMold->collision.height) {
+            maxHeight = pMold->collision.height;
+        }
+    }
+    const UINT8 slotNumber = (images - TILE_VARIETY) / 2 < ATLAS_FRAME_SLOTS
+        ? (images - TILE_VARIETY) / 2 : ATLAS_FRAME_SLOTS;
+    const UINT32 slotBytes = 2 * measureAtlasImage(maxWidth, maxHeight);
+    const UINT32 tableBytes = alignAtlasBytes(images * (sizeof(sSpanImage)
+        + sizeof(BOOLEAN) + sizeof(UINT8)));
+    const UINT32 tileBytes = TILE_VARIETY * measureAtlasImage(TILE_SIZE,
+        TILE_SIZE);
+    const UINT32 bytes = tableBytes + tileBytes + slotNumber * slotBytes;
+#ifdef _WIN32
+    BYTE* const pMemory = VirtualAlloc(NULL, bytes,
+        MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    // Mapping the zero device is how pages are requested without a file
+    // on every POSIX system.
+    BYTE* pMemory = NULL;
+    const INT fileDescriptor = open("/dev/zero", O_RDWR);
+    if (fileDescriptor >= 0) {
+        pMemory = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+            fileDescriptor, 0);
+        if (pMemory == MAP_FAILED) {
+            pMemory = NULL;
+        }
+        // The mapping remains valid once its file descriptor is closed.
+        close(fileDescriptor);
+    }
+#endif
+    sPixel* const pFramePixels = malloc((UINT32) maxWidth * maxHeight
+        * sizeof(sPixel));
+    if (pMemory == NULL || pFramePixels == NULL) {
+        free(pFramePixels);
+        gAtlas.pMemory = pMemory;
+        gAtlas.bytes = bytes;
+        freeAtlas();
+        panic("Memory allocation of the atlas failed.");
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    gAtlas.pMemory = pMemory;
+    gAtlas.bytes = bytes;
+    gAtlas.pImages = (sSpanImage*) pMemory;
+    gAtlas.pIsDecoded = (BOOLEAN*) (gAtlas.pImages + images);
+    gAtlas.pImageSlots = gAtlas.pIsDecoded + images;
+    gAtlas.pSlotMemory = pMemory + tableBytes + tileBytes;
+    gAtlas.slotBytes = slotBytes;
+    gAtlas.pFramePixels = pFramePixels;
+    gAtlas.images = images;
+    gAtlas.slotNumber = slotNumber;
+
+    BYTE* pImageMemory = pMemory + tableBytes;
+    UINT8* pIndexedPixels;
+    for (UINT8 tileId = 0; tileId < TILE_VARIETY; tileId++) {
+        pIndexedPixels = placeAtlasImage(pImageMemory, TILE_SIZE, TILE_SIZE,
+            &gAtlas.pImages[tileId]);
+        indexPixels(gpTilePixels + tileId * TILE_SIZE * TILE_SIZE,
+            TILE_SIZE * TILE_SIZE, pIndexedPixels);
+        buildOpaqueSpans(&gAtlas.pImages[tileId]);
+        gTileOpacities[tileId] = classifyTileOpacity(
+            &gAtlas.pImages[tileId]);
+        gAtlas.pIsDecoded[tileId] = TRUE;
+        pImageMemory += measureAtlasImage(TILE_SIZE, TILE_SIZE);
+    }
+    free(gpTilePixels);
+    gpTilePixels = NULL;
+
+    // Frames are only described once decoded in a slot, such that no page
+    // of a slot is written until a frame is decoded in it.
+    UINT16 image = TILE_VARIETY;
+    for (UINT8 moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {
+        gAtlas.moldImages[moldId] = image;
+        image += 2 * gCharacterMolds[moldId].frames;
+    }
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "measureAtlasImage" function returns the number of bytes that an
+ * image of the passed size takes in the atlas. Its span memory holds as
+ * many spans as its height times the "maxSpansOf" macro of its width.
+ */
+
+__forceinline UINT32 measureAtlasImage(
+        const UINT8 width,
+        const UINT8 height) {
+    // The span lists of an image start on the first even byte past its
+    // 3-3-2 colors, which is the alignment of their indices.
+    return alignAtlasBytes(((UINT32) width * height + 1) / 2 * 2
+        + (height + 1) * sizeof(UINT16)
+        + height * maxSpansOf(width) * sizeof(sSpan));
+}
+
+/*
+ * The "placeAtlasImage" function lays out an image of the passed size at
+ * the passed memory of the atlas, and describes it by the passed image.
+ * The address of its 3-3-2 colors is returned, for them to be written
+ * before its opaque spans are built.
+ */
+
+__forceinline UINT8* placeAtlasImage(
+        BYTE* const restrict pImageMemory,
+        const UINT8 width,
+        const UINT8 height,
+        sSpanImage* const restrict pImage) {
+
+    UINT16* const pRowSpans = (UINT16*) (pImageMemory
+        + ((UINT32) width * height + 1) / 2 * 2);
+    *pImage = (sSpanImage) {
+        pImageMemory,
+        pRowSpans,
+        (sSpan*) (pRowSpans + height + 1),
+        width,
+        height};
+    return pImageMemory;
+}
+
+/*
+ * The "fetchTileImage" function returns the 3-3-2 colors and opaque spans
+ * of the passed tile, which are the image of the atlas of the same index.
+ */
+
+__forceinline const sSpanImage* fetchTileImage(const UINT8 tileId) {
+    return &gAtlas.pImages[tileId];
+}
+
+/*
+ * The "decodeAtlasFrame" function decodes the passed frame of the passed
+ * mold in the buffer of pixels of the atlas, and packs its 3-3-2 colors and
+ * opaque spans in the passed slot, as the passed image of the atlas, then
+ * as the next one mirrored. FALSE is returned if memory to decode the frame
+ * cannot be allocated.
+ */
+
+__forceinline BOOLEAN decodeAtlasFrame(
+        const UINT8 moldId,
+        const UINT8 frame,
+        const UINT16 image,
+        const UINT8 slot) {
+
+    const sMold* const pMold = &gCharacterMolds[moldId];
+    const UINT8 width = pMold->collision.width;
+    const UINT8 height = pMold->collision.height;
+    if (!decodeMoldFrame(pMold, frame, gAtlas.pFramePixels)) {
+        return FALSE;
+    }
+    BYTE* const pImageMemory = gAtlas.pSlotMemory + slot * gAtlas.slotBytes;
+    UINT8* const pIndexedPixels = placeAtlasImage(pImageMemory, width,
+        height, &gAtlas.pImages[image]);
+    UINT8* const pMirroredPixels = placeAtlasImage(pImageMemory
+        + measureAtlasImage(width, height), width, height,
+        &gAtlas.pImages[image + 1]);
+    indexPixels(gAtlas.pFramePixels, width * height, pIndexedPixels);
+    mirrorMoldFrame(pIndexedPixels, width, height, pMirroredPixels);
+    buildOpaqueSpans(&gAtlas.pImages[image]);
+    buildOpaqueSpans(&gAtlas.pImages[image + 1]);
+    gAtlas.pIsDecoded[image] = TRUE;
+    gAtlas.pIsDecoded[image + 1] = TRUE;
+    gAtlas.pImageSlots[image] = slot;
+    return TRUE;
+}
+
+/*
+ * The "fetchMoldFrame" function returns the 3-3-2 colors and opaque spans
+ * of the passed frame of the passed mold, mirrored if requested. The frame
+ * is decoded in both orientations if no slot holds it, in an empty slot if
+ * any, or in the least recently fetched one otherwise, whose frame is
+ * evicted. The returned image remains valid until as many other frames as
+ * there are slots are fetched. A null address is returned if the atlas is
+ * not built, or if the frame cannot be decoded.
+ */
+
+__forceinline const sSpanImage* fetchMoldFrame(
+        const UINT8 moldId,
+        const UINT8 frame,
+        const BOOLEAN isMirrored) {
+
+    if (gAtlas.pImages == NULL) {
+        return NULL;
+    }
+    gAtlas.clock++;
+    const UINT16 image = gAtlas.moldImages[moldId] + 2 * frame;
+    if (gAtlas.pIsDecoded[image]) {
+        gAtlas.slots[gAtlas.pImageSlots[image]].lastUse = gAtlas.clock;
+        gAtlas.frameHits++;
+        return &gAtlas.pImages[image + isMirrored];
+    }
+
+    gAtlas.frameMisses++;
+    // Empty slots feature a use of zero, which is the least of all.
+    UINT8 slot = 0;
+    for (UINT8 i = 1; i < gAtlas.slotNumber; i++) {
+        if (gAtlas.slots[i].lastUse < gAtlas.slots[slot].lastUse) {
+            slot = i;
+        }
+    }
+    sAtlasSlot* const pSlot = &gAtlas.slots[slot];
+    if (pSlot->lastUse != 0) {
+        gAtlas.pIsDecoded[pSlot->image] = FALSE;
+        gAtlas.pIsDecoded[pSlot->image + 1] = FALSE;
+        pSlot->lastUse = 0;
+        gAtlas.frameEvictions++;
+    }
+    if (!decodeAtlasFrame(moldId, frame, image, slot)) {
+        return NULL;
+    }
+    pSlot->lastUse = gAtlas.clock;
+    pSlot->image = image;
+    return &gAtlas.pImages[image + isMirrored];
+}
+
+/*
+ * The "freeAtlas" function releases the pages of the atlas, and with them
+ * every image it holds, as well as its buffer of pixels.
+ */
+
+__forceinline void freeAtlas() {
+
+    free(gAtlas.pFramePixels);
+    if (gAtlas.pMemory != NULL) {
+#ifdef _WIN32
+        VirtualFree(gAtlas.pMemory, 0, MEM_RELEASE);
+#else
+        munmap(gAtlas.pMemory, gAtlas.bytes);
+#endif
+    }
+    gAtlas = (sAtlas) {0};
+    return;
+}
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "coordinator.h"
+#include "read.h"
+#include "management_bundle.h"
 #include "decode.h"
-#include "dir.h"
+#include "cache.h"
+#include "prop_dir.h"
 
 /*
  * The function prototypes highlighted in this file pertain to
@@ -10,71 +13,58 @@
  * other textures in the rendering protocol.
  */
 
+// The array below holds the 3-3-2 colors of the screen of background that
+// the indexed render mode composites.
+UINT8 gIndexedBackground[BACKBUFFER_HEIGHT * BACKBUFFER_WIDTH];
+
 __forceinline LRESULT initBackground(
         sPixel* const restrict pPixelRegion,
-        const UINT32 pixels,
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData);
+        const UINT32 pixels);
 
 
 /*
  * The "initBackground" function sets all pixels of the passed pixel
- * array. The set pixels are from the "bck.bci" file.
+ * array. The set pixels are from the "bck.bci" file. They are read from the
+ * decoded asset cache instead if this file is unchanged since it was last
+ * decoded. The pixels of the first screen are then indexed as 3-3-2
+ * colors.
  */
 
 __forceinline LRESULT initBackground(
         sPixel* const restrict pPixelRegion,
-        const UINT32 pixels,
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData) {
-    
-    FILE* pFile = fopen(DIR_BACKGROUND, "rb");
+        const UINT32 pixels) {
     
-    if (pFile == NULL) {
+    sMappedFile file;
+    if (mapAsset(ASSET_BACKGROUND, 0, DIR_BACKGROUND, &file)
+            != ERROR_SUCCESS) {
         panic("Background graphic is missing in " DIR_BACKGROUND ".");
         return ERROR_FILE_NOT_FOUND;
     }
     
-    switch(fReadImage(
-            pixels,
-            pFile,
-            pColors,
-            pColorCodeBits,
-            pEncodedPixelDataBytes,
-            ppPalette,
-            ppColorCodeToPixelMapping,
-            ppEncodedPixelData)) {
-        
-        case ERROR_NOT_ENOUGH_MEMORY:
-        
-        return ERROR_NOT_ENOUGH_MEMORY;
-        
-        case ERROR_SUCCESS:
-        
-        break;
-        
-        default:
-        
+    const UINT32 indexedPixels = pixels < BACKBUFFER_HEIGHT * BACKBUFFER_WIDTH
+        ? pixels : BACKBUFFER_HEIGHT * BACKBUFFER_WIDTH;
+    const UINT64 key = hashBytes(file.pData, file.size, DECODER_VERSION);
+    if (readDecodedCache(DIR_CACHE_BACKGROUND, key, pixels, pPixelRegion)) {
+        unmapFile(&file);
+        indexPixels(pPixelRegion, indexedPixels, gIndexedBackground);
+        return ERROR_SUCCESS;
+    }
+    
+    sEncodedImage image;
+    UINT32 offset = 0;
+    if (readImage(pixels, &file, &offset, &image) != ERROR_SUCCESS) {
+        unmapFile(&file);
+        panic("Background graphic " DIR_BACKGROUND " is truncated.");
         return ERROR_INVALID_DATA;
     }
-    fclose(pFile);
     
-    decodePixelDataFeaturing(
-        *pColors,
-        *pColorCodeBits,
-        *pEncodedPixelDataBytes,
-        *ppPalette,
-        *ppColorCodeToPixelMapping,
-        *ppEncodedPixelData,
+    // Backgrounds can span several screens. Large ones are decoded by
+    // several workers.
+    decodeImage(countTaskWorkers(TASK_MAX_WORKERS), &image, pixels,
         pPixelRegion);
+    unmapFile(&file);
+    writeDecodedCache(DIR_CACHE_BACKGROUND, key, pixels, pPixelRegion);
+    indexPixels(pPixelRegion, indexedPixels, gIndexedBackground);
     
     return ERROR_SUCCESS;
 }
\ No newline at end of file
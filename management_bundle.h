@@ -0,0 +1,116 @@
+#pragma once
+
+#include "coordinator.h"
+#include "read.h"
+#include "prop_bundle.h"
+#include "prop_dir.h"
+
+/*
+ * The functions declared in this file pertain to the asset bundle. This
+ * bundle is a single file packing every asset that initialization
+ * procedures read. The packing tool built from "pack.c" produces it from the
+ * "user" directory. If the bundle is absent, assets are read from their
+ * individual files instead.
+ */
+
+__forceinline LRESULT initBundle();
+
+__forceinline LRESULT mapAsset(
+    const UINT8 type,
+    const UINT8 id,
+    const CHAR* const restrict pDir,
+    sMappedFile* const restrict pMappedFile);
+
+__forceinline void freeBundle();
+
+// The variables below hold the mapping of the entire bundle and the number
+// of entries of its index.
+sMappedFile gBundle;
+UINT16 gBundleEntries = 0;
+BOOLEAN gIsBundleLoaded = FALSE;
+
+/*
+ * The "initBundle" function maps the bundle and validates its header and
+ * index. The absence of the bundle is not an error.
+ */
+
+__forceinline LRESULT initBundle() {
+
+    if (mapFile(DIR_BUNDLE, &gBundle) != ERROR_SUCCESS) {
+        return ERROR_SUCCESS;
+    }
+    const BYTE* const pHeader = gBundle.pData;
+    if (gBundle.size < BUNDLE_HEADER_BYTES
+            || memcmp(pHeader, BUNDLE_MAGIC, 4) != 0
+            || pHeader[4] != BUNDLE_VERSION) {
+        unmapFile(&gBundle);
+        panic("Asset bundle " DIR_BUNDLE " is invalid.");
+        return ERROR_INVALID_DATA;
+    }
+    gBundleEntries = pHeader[6] | (pHeader[7] << 8);
+    if ((gBundle.size - BUNDLE_HEADER_BYTES) / BUNDLE_ENTRY_BYTES
+            < gBundleEntries) {
+        unmapFile(&gBundle);
+        panic("Asset bundle " DIR_BUNDLE " is truncated.");
+        return ERROR_INVALID_DATA;
+    }
+    gIsBundleLoaded = TRUE;
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "mapAsset" function describes the asset of the passed type and
+ * identifier as a mapped file. The asset is a view into the bundle if a
+ * bundle is loaded. Otherwise, the file found at the passed directory is
+ * mapped. In both cases, the "unmapFile" function must be called once the
+ * asset is no longer read. An asset that is missing from a loaded bundle,
+ * or that extends beyond its end, is reported as not found.
+ */
+
+__forceinline LRESULT mapAsset(
+        const UINT8 type,
+        const UINT8 id,
+        const CHAR* const restrict pDir,
+        sMappedFile* const restrict pMappedFile) {
+
+    if (!gIsBundleLoaded) {
+        return mapFile(pDir, pMappedFile);
+    }
+
+    const BYTE* pEntry = gBundle.pData + BUNDLE_HEADER_BYTES;
+    UINT32 offset, size;
+    for (UINT16 i = 0; i < gBundleEntries;
+            i++, pEntry += BUNDLE_ENTRY_BYTES) {
+        if (pEntry[0] != type || pEntry[1] != id) {
+            continue;
+        }
+        offset = pEntry[4] | (pEntry[5] << 8) | (pEntry[6] << 16)
+            | ((UINT32) pEntry[7] << 24);
+        size = pEntry[8] | (pEntry[9] << 8) | (pEntry[10] << 16)
+            | ((UINT32) pEntry[11] << 24);
+        if (offset > gBundle.size || gBundle.size - offset < size) {
+            break;
+        }
+        pMappedFile->pData = gBundle.pData + offset;
+        pMappedFile->size = size;
+        pMappedFile->isView = TRUE;
+        return ERROR_SUCCESS;
+    }
+    return ERROR_FILE_NOT_FOUND;
+}
+
+/*
+ * The "freeBundle" function unmaps the bundle. It is called once all
+ * initialization procedures reading assets are complete, since every asset
+ * is copied or decoded elsewhere.
+ */
+
+__forceinline void freeBundle() {
+
+    if (gIsBundleLoaded) {
+        unmapFile(&gBundle);
+        gIsBundleLoaded = FALSE;
+    }
+    gBundleEntries = 0;
+    return;
+}
@@ -2,11 +2,9 @@
 
 #include "coordinator.h"
 #include "read.h"
+#include "management_bundle.h"
 #include "prop_character.h"
 
-#define bitmapDirOf(character) DIR_CHARACTER #character ".bci"
-#define moldDirOf(character) DIR_CHARACTER #character ".mld"
-
 #include "prop_dir.h"
 
 /*
@@ -14,13 +12,7 @@
  * characters in a level. Such functions must all be included in this file.
  */
 
-__forceinline LRESULT initCharacterMolds(
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData);
+__forceinline LRESULT initCharacterMolds();
 
 __forceinline void freeCharactersMolds();
 
@@ -28,16 +20,12 @@ __forceinline void freeCharactersMolds();
  * The "initCharacterMolds" function is called exactly once in the main 
  * function of this program. This call's intent is to create so called 
  * "molds" for characters. These items are used as bases for all created 
- * characters to have their attributes initialized from.
+ * characters to have their attributes initialized from. The graphics of a
+ * mold are copied in their encoded form. Each of their frames is only
+ * decoded once rendered, in its room of the atlas.
  */
 
-__forceinline LRESULT initCharacterMolds(
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData) {    
+__forceinline LRESULT initCharacterMolds() {    
     
     const CHAR* dirPixelData[] = generateCharacterArray(bitmapDirOf);
     const CHAR* dirMold[] = generateCharacterArray(moldDirOf);
@@ -45,87 +33,83 @@ __forceinline LRESULT initCharacterMolds(
     // initializations of all character molds that specifically pertainin
     // to the allocation of memory and the creation of color codes within
     // this initialization process.
-    UINT16 encodedPixelDataPixels;
+    UINT32 encodedPixelDataPixels;
     sMold curMold;
-    sPixel* pDecodedImage;
+    BYTE* pEncodedData;
+    sMappedFile file;
+    sEncodedImage image;
+    UINT32 offset;
     for (UINT moldId = 0; moldId < CHARACTER_VARIETY; moldId++) {        
-        FILE* pFile = fopen(dirMold[moldId], "rb");
-        if (pFile == NULL) {
+        if (mapAsset(ASSET_MOLD, moldId, dirMold[moldId], &file)
+                != ERROR_SUCCESS) {
             panic("Mold file is missing in " DIR_CHARACTER ".");
             return ERROR_FILE_NOT_FOUND;
         }
+        if (file.size < sizeof(curMold.moldInfo)) {
+            unmapFile(&file);
+            panic("Mold file in " DIR_CHARACTER " is truncated.");
+            return ERROR_INVALID_DATA;
+        }
         
         // The command below initializes the collision, maximum horizontal
         // speed, and the number of distinct frames that the mold features.
-        fread(&curMold.moldInfo, sizeof(sMold), 1, pFile);
-        fclose(pFile);
+        memcpy(&curMold.moldInfo, file.pData, sizeof(curMold.moldInfo));
+        unmapFile(&file);
         
         encodedPixelDataPixels = curMold.collision.width
             * curMold.collision.height * curMold.frames;
         
-        pFile = fopen(dirPixelData[moldId], "rb");
-        if (pFile == NULL) {
+        if (mapAsset(ASSET_CHARACTER_GRAPHIC, moldId,
+                dirPixelData[moldId], &file) != ERROR_SUCCESS) {
             panic("Character graphic data was not found in " 
                 DIR_CHARACTER ".");
             return ERROR_FILE_NOT_FOUND;
         }
         
-        switch(fReadImage(
-                encodedPixelDataPixels,
-                pFile,
-                pColors,
-                pColorCodeBits,
-                pEncodedPixelDataBytes,
-                ppPalette,
-                ppColorCodeToPixelMapping,
-                ppEncodedPixelData)) {
-            
-            case ERROR_NOT_ENOUGH_MEMORY:
-            
-            return ERROR_NOT_ENOUGH_MEMORY;
-            
-            case ERROR_SUCCESS:
-            
-            break;
-            
-            default:
-            
+        offset = 0;
+        if (readImage(encodedPixelDataPixels, &file, &offset, &image)
+                != ERROR_SUCCESS) {
+            unmapFile(&file);
+            panic("Character graphic data in " DIR_CHARACTER 
+                " is truncated.");
             return ERROR_INVALID_DATA;
         }
-        fclose(pFile);
         
-        pDecodedImage = malloc(encodedPixelDataPixels * BYTES_PER_PIXEL);
-        
-        decodePixelDataFeaturing(
-            *pColors,
-            *pColorCodeBits,
-            *pEncodedPixelDataBytes,
-            *ppPalette,
-            *ppColorCodeToPixelMapping,
-            *ppEncodedPixelData,
-            pDecodedImage);
+        // The palette and the encoded pixel data are copied one after the
+        // other, since the mapping is released below.
+        pEncodedData = malloc(image.colors + image.encodedPixelDataBytes);
+        if (pEncodedData == NULL) {
+            unmapFile(&file);
+            panic("Memory allocation of character graphics data failed.");
+            return ERROR_NOT_ENOUGH_MEMORY;
+        }
+        memcpy(pEncodedData, image.pPalette, image.colors);
+        memcpy(pEncodedData + image.colors, image.pEncodedPixelData,
+            image.encodedPixelDataBytes);
+        unmapFile(&file);
         
-        // The command below associates the current character mold's
-        // provides a value to the 
-        curMold.pPixelData = pDecodedImage;
-        // Since the variable describing the amount of bits per color code is
-        // computed by incrementing, it must be reset back to zero for the next
-        // iteration.
-        *pColorCodeBits = 0;
+        curMold.colors = image.colors;
+        curMold.colorCodeBits = image.colorCodeBits;
+        curMold.encodedPixelDataBytes = image.encodedPixelDataBytes;
+        curMold.isRunLength = image.isRunLength;
+        curMold.pEncodedData = pEncodedData;
         // The finalized mold can now be placed into the array reserved for
         // containing all molds created in this program.
         gCharacterMolds[moldId] = curMold;
     }
-    // The temporary pointer to set the pixel data in the allocated memories
-    // to each character mold must not be pointing to anything after being
-    // used.
-    pDecodedImage = NULL;
+    // The temporary pointer to set the encoded data in the allocated
+    // memories to each character mold must not be pointing to anything
+    // after being used.
+    pEncodedData = NULL;
     return ERROR_SUCCESS;
 }
 
 __forceinline void freeCharactersMolds() {
+    // Frames that the atlas did not decode yet can no longer be fetched
+    // once the molds below are freed.
     for (UINT8 i = 0; i < CHARACTER_VARIETY; i++) {
-        free(gCharacterMolds[i].pPixelData);
+        free(gCharacterMolds[i].pEncodedData);
+        gCharacterMolds[i].pEncodedData = NULL;
     }
     return;
 }
\ No newline at end of file
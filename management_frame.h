@@ -0,0 +1,116 @@
+#pragma once
+
+#include "coordinator.h"
+#include "decode.h"
+
+/*
+ * The functions of this file decode the animation frames of character
+ * molds, which keep their pixel data encoded. Every frame is packed in the
+ * atlas in both orientations the first time it is fetched, such that
+ * mirrored characters are rendered by copying spans as well.
+ */
+
+__forceinline void mirrorMoldFrame(
+    const UINT8* const restrict pPixels,
+    const UINT8 width,
+    const UINT8 height,
+    UINT8* const restrict pMirroredPixels);
+
+__forceinline BOOLEAN decodeMoldFrame(
+    const sMold* const restrict pMold,
+    const UINT8 frame,
+    sPixel* const restrict pDestination);
+
+/*
+ * The "mirrorMoldFrame" function writes the pixels of a frame with every
+ * row reversed, which is how mirrored characters appear.
+ */
+
+__forceinline void mirrorMoldFrame(
+        const UINT8* const restrict pPixels,
+        const UINT8 width,
+        const UINT8 height,
+        UINT8* const restrict pMirroredPixels) {
+
+    for (UINT32 row = 0; row < (UINT32) width * height; row += width) {
+        for (UINT8 column = 0; column < width; column++) {
+            pMirroredPixels[row + column] = pPixels[row + width - 1
+                - column];
+        }
+    }
+    return;
+}
+
+/*
+ * The "decodeMoldFrame" function decodes a single frame of a mold. The
+ * frames of run-length coded graphics are decoded by skipping the pixels of
+ * all preceding frames in the run stream. Packed frames start on a byte
+ * boundary only if the bits of a frame are a multiple of eight. The bits of
+ * other frames are first shifted into a temporary buffer for them to start
+ * on a byte boundary, as the decoder requires.
+ */
+
+__forceinline BOOLEAN decodeMoldFrame(
+        const sMold* const restrict pMold,
+        const UINT8 frame,
+        sPixel* const restrict pDestination) {
+
+    const UINT32 framePixels = pMold->collision.width
+        * pMold->collision.height;
+    const UINT32 frameBits = framePixels * pMold->colorCodeBits;
+    const UINT32 startBit = frame * frameBits;
+    const UINT32 frameBytes = (frameBits + 7) / 8;
+    const BYTE* const pPalette = pMold->pEncodedData;
+    const BYTE* const pFrameData = pMold->pEncodedData + pMold->colors
+        + startBit / 8;
+    const UINT8 bitShift = startBit % 8;
+
+    if (pMold->isRunLength) {
+        decodeRunLengthPixelData(
+            pMold->colors,
+            pMold->colorCodeBits,
+            frame * framePixels,
+            framePixels,
+            pMold->encodedPixelDataBytes,
+            pPalette,
+            pMold->pEncodedData + pMold->colors,
+            pDestination);
+        return TRUE;
+    }
+    if (bitShift == 0) {
+        decodePixelDataFeaturing(
+            pMold->colors,
+            pMold->colorCodeBits,
+            framePixels,
+            frameBytes,
+            pPalette,
+            pFrameData,
+            pDestination);
+        return TRUE;
+    }
+
+    BYTE* const pAlignedData = malloc(frameBytes);
+    if (pAlignedData == NULL) {
+        return FALSE;
+    }
+    // The last byte of the frame may be the last byte of the encoded pixel
+    // data, past which nothing can be read.
+    const UINT32 availableBytes = pMold->encodedPixelDataBytes
+        - startBit / 8;
+    for (UINT32 i = 0; i < frameBytes; i++) {
+        pAlignedData[i] = pFrameData[i] << bitShift;
+        if (i + 1 < availableBytes) {
+            pAlignedData[i] |= pFrameData[i + 1] >> (8 - bitShift);
+        }
+    }
+    decodePixelDataFeaturing(
+        pMold->colors,
+        pMold->colorCodeBits,
+        framePixels,
+        frameBytes,
+        pPalette,
+        pAlignedData,
+        pDestination);
+    free(pAlignedData);
+    return TRUE;
+}
\ No newline at end of file
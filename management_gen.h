@@ -1,6 +1,8 @@
 #pragma once
 
 #include "coordinator.h"
+#include "management_bundle.h"
+#include "prop_bundle.h"
 #include "prop_dir.h"
 
 /*
@@ -36,7 +38,13 @@ __forceinline LRESULT initActors() {
     #define SEARCHING_X 0x10
     #define SEARCHING_Y 0x20
     
-    FILE* pFile = fopen(DIR_FIRST_GEN, "rb");
+    sMappedFile file;
+    if (mapAsset(ASSET_GEN, 0, DIR_FIRST_GEN, &file) != ERROR_SUCCESS) {
+        panic("Generation file " DIR_FIRST_GEN " was not found.");
+        return ERROR_FILE_NOT_FOUND;
+    }
+    // The generation file is parsed in chunks copied from its mapping.
+    UINT32 offset = 0;
     
     BYTE chunk[CHUNK_SIZE];
     UINT8 extractedChars;
@@ -49,7 +57,10 @@ __forceinline LRESULT initActors() {
     UINT32 curBrackets = 0;
     
     do {
-        extractedChars = fread(chunk, sizeof(BYTE), sizeof(chunk), pFile);
+        extractedChars = file.size - offset < sizeof(chunk) ?
+            file.size - offset : sizeof(chunk);
+        memcpy(chunk, file.pData + offset, extractedChars);
+        offset += extractedChars;
         for (i = 0; i < extractedChars; i++) {
             if ((flag & READING_COMMENT) != 0) {
                 flag |= READING_COMMENT;
@@ -88,6 +99,7 @@ __forceinline LRESULT initActors() {
                 
                 prevBrackets = curBrackets--;
                 if (prevBrackets < curBrackets) {
+                    unmapFile(&file);
                     goto unmatchedBracket;
                 }
                 // Fallthrough
@@ -112,6 +124,7 @@ __forceinline LRESULT initActors() {
                     gInitialCharacterArray.pCharacter = malloc(
                         characterArrayBytes);
                     if (gMutableCharacterArray.pCharacter == NULL) {
+                        unmapFile(&file);
                         panic("Actor memoy allocation failed.");
                         return ERROR_NOT_ENOUGH_MEMORY;
                     }
@@ -154,12 +167,13 @@ __forceinline LRESULT initActors() {
                 
                 default:
 
+                unmapFile(&file);
                 panic("Bad data in " DIR_FIRST_GEN ".");
                 return ERROR_INVALID_DATA;
             }
         }
     } while (extractedChars == sizeof(chunk));
-    fclose(pFile);
+    unmapFile(&file);
     
     if (curBrackets != 0) {
         unmatchedBracket:
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "coordinator.h"
+#include "prop_image.h"
+
+/*
+ * The functions of this file describe the opaque pixels of decoded images
+ * as spans. A span is a sequence of consecutive opaque pixels of a row.
+ * Images are rendered by copying their spans whole, such that transparent
+ * pixels are skipped without being tested. Spans are built once, when an
+ * image is decoded. Images keep their pixels as 3-3-2 colors, a byte each,
+ * which are expanded to pixels as they are rendered.
+ */
+
+// An image row features at most as many spans as below, since two spans of
+// a row are separated by at least one transparent pixel.
+#define maxSpansOf(width) (((width) + 1) / 2)
+
+// The struct below describes a span of opaque pixels by the column of its
+// first pixel and its number of pixels.
+typedef struct {
+    UINT8 start;
+    UINT8 length;
+} sSpan;
+
+// The struct below describes a decoded image and the opaque spans of its
+// rows, from left to right. The spans of a row start at the index that
+// "pRowSpans" features for this row, and end at the index it features for
+// the next row. As such, this array features an index more than there are
+// rows. The pixels of the image are its 3-3-2 colors, row by row.
+typedef struct {
+    const UINT8* pIndexedPixels;
+    UINT16* pRowSpans;
+    sSpan* pSpans;
+    UINT8 width;
+    UINT8 height;
+} sSpanImage;
+
+__forceinline void buildOpaqueSpans(sSpanImage* const restrict pImage);
+
+/*
+ * The "buildOpaqueSpans" function finds the opaque spans of every row of
+ * the passed image. The span memory of the image must hold as many spans as
+ * its height times the "maxSpansOf" macro of its width.
+ */
+
+__forceinline void buildOpaqueSpans(sSpanImage* const restrict pImage) {
+
+    const UINT8* pRow = pImage->pIndexedPixels;
+    UINT16 spans = 0;
+    UINT8 start;
+    for (UINT8 row = 0; row < pImage->height; row++) {
+        pImage->pRowSpans[row] = spans;
+        for (UINT8 column = 0; column < pImage->width;) {
+            if (pRow[column] == PALETTE_TRANSPARENT) {
+                column++;
+                continue;
+            }
+            start = column;
+            while (column < pImage->width
+                    && pRow[column] != PALETTE_TRANSPARENT) {
+                column++;
+            }
+            pImage->pSpans[spans++] = (sSpan) {start, column - start};
+        }
+        pRow += pImage->width;
+    }
+    pImage->pRowSpans[pImage->height] = spans;
+    return;
+}
\ No newline at end of file
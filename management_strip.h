@@ -0,0 +1,181 @@
+#pragma once
+
+#include "coordinator.h"
+#include "managment_level.h"
+#include "management_tile.h"
+#include "management_span.h"
+#include "management_atlas.h"
+#include "render_indexed.h"
+
+/*
+ * The functions of this file manage the tile strip, a ring of tile columns
+ * of the level composited ahead of rendering. The strip is slightly wider
+ * than the backbuffer, such that every tile column in the viewport features
+ * a slot of the strip. Level columns are held by the slot of their index
+ * modulo the number of slots, such that a scrolling camera only composites
+ * the columns it newly exposes. The opaque pixels of every row of the strip
+ * are described by runs, which merge the opaque spans of adjacent tiles.
+ * Rows of solid tiles are thus rendered by a single copy. The background is
+ * not composited in the strip, since it does not scroll with the tiles.
+ */
+
+// The strip features two columns more than fit in the backbuffer, since a
+// viewport cut off on both sides features one more column than fits.
+#define STRIP_COLUMNS (BACKBUFFER_WIDTH / TILE_SIZE + 2)
+#define STRIP_WIDTH (STRIP_COLUMNS * TILE_SIZE)
+#define STRIP_HEIGHT (COLUMN_SIZE * TILE_SIZE)
+
+// The struct below describes a run of opaque pixels of a row of the strip
+// by the column of its first pixel and its number of pixels.
+typedef struct {
+    UINT16 start;
+    UINT16 length;
+} sStripRun;
+
+// The pixels of the strip are stored row by row, from the bottom row
+// upwards, and so are their 3-3-2 colors. The runs of a row start at the
+// index that "gStripRowRuns" features for this row, and end at the index
+// it features for the next row.
+sPixel gStripPixels[STRIP_HEIGHT * STRIP_WIDTH];
+UINT8 gIndexedStripPixels[STRIP_HEIGHT * STRIP_WIDTH];
+UINT16 gStripRowRuns[STRIP_HEIGHT + 1];
+sStripRun gStripRuns[STRIP_HEIGHT * maxSpansOf(STRIP_WIDTH)];
+// Every slot of the strip holds the level column whose index is one less
+// than the value below, such that no slot holds any column initially.
+UINT16 gStripColumns[STRIP_COLUMNS] = {0};
+// The number of tiles of each opacity in the latest updated viewport, which
+// is shown in the debug overlay.
+UINT16 gViewportOpacities[OPACITY_VARIETY] = {0};
+
+__forceinline void updateTileStrip(
+    const UINT16 firstColumn,
+    const UINT8 columns);
+
+__forceinline void compositeStripColumn(const UINT16 column);
+
+__forceinline void buildStripRuns();
+
+/*
+ * The "updateTileStrip" function composites in the strip the passed number
+ * of level columns from the passed first one, if their slots do not hold
+ * them already. The runs of the strip are rebuilt if any column is
+ * composited, which happens once per tile width that the camera scrolls.
+ * The tiles of every passed column are counted by their opacity.
+ */
+
+__forceinline void updateTileStrip(
+        const UINT16 firstColumn,
+        const UINT8 columns) {
+
+    BOOLEAN isComposited = FALSE;
+    memset(gViewportOpacities, 0x00, sizeof(gViewportOpacities));
+    for (UINT16 column = firstColumn;
+            column < firstColumn + columns;
+            column++) {
+        if (gStripColumns[column % STRIP_COLUMNS] != column + 1) {
+            compositeStripColumn(column);
+            isComposited = TRUE;
+        }
+        for (UINT8 row = 0; row < COLUMN_SIZE; row++) {
+            gViewportOpacities[gTileOpacities[
+                gLevel.pTilemap[column * COLUMN_SIZE + row]]]++;
+        }
+    }
+    if (isComposited) {
+        buildStripRuns();
+    }
+    return;
+}
+
+/*
+ * The "compositeStripColumn" function expands the tiles of a level column
+ * from the atlas in its slot of the strip, and copies their 3-3-2 colors
+ * alongside. Tiles are copied whole, since the runs of the strip skip
+ * their transparent pixels. Transparent tiles feature no runs, and are not
+ * copied at all.
+ */
+
+__forceinline void compositeStripColumn(const UINT16 column) {
+
+    const UINT8 slot = column % STRIP_COLUMNS;
+    const UINT8* const pTileIds = gLevel.pTilemap + column * COLUMN_SIZE;
+    sPixel* pStripRow = gStripPixels + slot * TILE_SIZE;
+    UINT8* pIndexedStripRow = gIndexedStripPixels + slot * TILE_SIZE;
+    const UINT8* pIndexedTile;
+    for (UINT8 tileRow = 0; tileRow < COLUMN_SIZE; tileRow++) {
+        if (gTileOpacities[pTileIds[tileRow]] == opacityTransparent) {
+            pStripRow += TILE_SIZE * STRIP_WIDTH;
+            pIndexedStripRow += TILE_SIZE * STRIP_WIDTH;
+            continue;
+        }
+        pIndexedTile = fetchTileImage(pTileIds[tileRow])->pIndexedPixels;
+        for (UINT8 row = 0; row < TILE_SIZE; row++) {
+            expandIndexedPixels(pIndexedTile + row * TILE_SIZE, TILE_SIZE,
+                pStripRow);
+            memcpy(pIndexedStripRow, pIndexedTile + row * TILE_SIZE,
+                TILE_SIZE * sizeof(UINT8));
+            pStripRow += STRIP_WIDTH;
+            pIndexedStripRow += STRIP_WIDTH;
+        }
+    }
+    gStripColumns[slot] = column + 1;
+    return;
+}
+
+/*
+ * The "buildStripRuns" function builds the runs of every row of the strip
+ * from the opaque spans of the tiles its slots hold. A span that starts
+ * where the previous run ends extends it, such that runs are as long as
+ * possible. Slots that hold no column feature no runs. Opaque tiles are
+ * added as a single span as wide as them, and transparent ones are
+ * skipped, such that only the spans of mixed tiles are visited.
+ */
+
+__forceinline void buildStripRuns() {
+
+    UINT16 runs = 0;
+    UINT16 column, start;
+    UINT8 tileId;
+    const sSpanImage* pTile;
+    const sSpan* pSpan;
+    const sSpan* pRowEnd;
+    const sSpan opaqueSpan = {0, TILE_SIZE};
+    for (UINT8 row = 0; row < STRIP_HEIGHT; row++) {
+        gStripRowRuns[row] = runs;
+        for (UINT8 slot = 0; slot < STRIP_COLUMNS; slot++) {
+            if (gStripColumns[slot] == 0) {
+                continue;
+            }
+            column = gStripColumns[slot] - 1;
+            tileId = gLevel.pTilemap[column * COLUMN_SIZE + row / TILE_SIZE];
+            switch(gTileOpacities[tileId]) {
+                case opacityTransparent:
+                continue;
+                
+                case opacityOpaque:
+                pSpan = &opaqueSpan;
+                pRowEnd = pSpan + 1;
+                break;
+                
+                default:
+                pTile = fetchTileImage(tileId);
+                pSpan = pTile->pSpans + pTile->pRowSpans[row % TILE_SIZE];
+                pRowEnd = pTile->pSpans 
+                    + pTile->pRowSpans[row % TILE_SIZE + 1];
+                break;
+            }
+            for (; pSpan < pRowEnd; pSpan++) {
+                start = slot * TILE_SIZE + pSpan->start;
+                if (runs > gStripRowRuns[row]
+                        && gStripRuns[runs - 1].start
+                            + gStripRuns[runs - 1].length == start) {
+                    gStripRuns[runs - 1].length += pSpan->length;
+                } else {
+                    gStripRuns[runs++] = (sStripRun) {start, pSpan->length};
+                }
+            }
+        }
+    }
+    gStripRowRuns[STRIP_HEIGHT] = runs;
+    return;
+}
@@ -2,7 +2,10 @@
 
 #include "coordinator.h"
 #include "read.h"
+#include "management_bundle.h"
 #include "decode.h"
+#include "cache.h"
+#include "management_span.h"
 #include "prop_dir.h"
 
 #define BLOCK_CHARACTER_MACROS
@@ -13,68 +16,100 @@
  * rendering.
  */
 
-__forceinline LRESULT initTilePixelData(
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData);
+__forceinline LRESULT initTilePixelData();
+
+__forceinline UINT8 classifyTileOpacity(
+    const sSpanImage* const restrict pTile);
+
+// The enumeration below lists the opacities of tiles. Transparent tiles are
+// skipped when rendering, and the rows of opaque tiles are copied whole.
+// Only the opaque spans of mixed tiles are rendered.
+enum {
+    opacityTransparent,
+    opacityOpaque,
+    opacityMixed,
+    OPACITY_VARIETY
+};
+
+// The address below holds the decoded pixels of every tile of the texture
+// map, one tile after the other, until they are packed in the atlas. The
+// array below describes the opacity of every tile, which is classified
+// once its opaque spans are built in the atlas.
+sPixel* gpTilePixels = NULL;
+UINT8 gTileOpacities[TILE_VARIETY];
 
 /*
  * The "initTilePixelData" function outlines the procedure required 
  * initialize graphic tile data. This initialization procedure includes
  * allocating memory for each unique tile graphic and their respective
- * initialization.
+ * initialization. The entire texture map is read from the decoded asset
+ * cache instead if it is unchanged since it was last decoded. Either way,
+ * the decoded tiles are kept until they are packed in the atlas.
  */
 
-__forceinline LRESULT initTilePixelData(
-        UINT8* const restrict pColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData) {
+__forceinline LRESULT initTilePixelData() {
     
-    FILE* pFile = fopen(DIR_TILE, "rb");    
-    if (pFile == NULL) {
+    // Tiles decoded before, but never packed, are decoded again below.
+    if (gpTilePixels == NULL) {
+        gpTilePixels = malloc(TILE_VARIETY * TILE_SIZE * TILE_SIZE
+            * sizeof(sPixel));
+        if (gpTilePixels == NULL) {
+            panic("Memory allocation of tile graphics data failed.");
+            return ERROR_NOT_ENOUGH_MEMORY;
+        }
+    }
+    sMappedFile file;
+    if (mapAsset(ASSET_TILE, 0, DIR_TILE, &file) != ERROR_SUCCESS) {
         panic("Texture map file \"" DIR_TILE "\" was not found.");
         return ERROR_FILE_NOT_FOUND;
     }
     
+    const UINT64 key = hashBytes(file.pData, file.size, DECODER_VERSION);
+    if (readDecodedCache(DIR_CACHE_TILE, key, TILE_VARIETY * TILE_SIZE
+            * TILE_SIZE, gpTilePixels)) {
+        unmapFile(&file);
+        return ERROR_SUCCESS;
+    }
+    
+    // Tile images are stored one after the other in the texture map. The
+    // offset below is advanced past every image read.
+    sEncodedImage image;
+    UINT32 offset = 0;
     for (UINT tileId = 0; tileId < TILE_VARIETY; tileId++) {
-        switch(fReadImage(
-                TILE_SIZE * TILE_SIZE,
-                pFile,
-                pColors,
-                pColorCodeBits,
-                pEncodedPixelDataBytes,
-                ppPalette,
-                ppColorCodeToPixelMapping,
-                ppEncodedPixelData)) {
-            
-            case ERROR_NOT_ENOUGH_MEMORY:
-            
-            return ERROR_NOT_ENOUGH_MEMORY;
-            
-            case ERROR_SUCCESS:
-
-            break;
-            
-            default:
-            
+        if (readImage(TILE_SIZE * TILE_SIZE, &file, &offset, &image)
+                != ERROR_SUCCESS) {
+            unmapFile(&file);
+            panic("Texture map file \"" DIR_TILE "\" is truncated.");
             return ERROR_INVALID_DATA;
         }
-        decodePixelDataFeaturing(
-            *pColors,
-            *pColorCodeBits,
-            *pEncodedPixelDataBytes,
-            *ppPalette,
-            *ppColorCodeToPixelMapping,
-            *ppEncodedPixelData,
-            (sPixel* restrict const) &(gTileAtlas[tileId][0]));
+        decodeImage(1, &image, TILE_SIZE * TILE_SIZE,
+            gpTilePixels + tileId * TILE_SIZE * TILE_SIZE);
     }
-    fclose(pFile);
+    unmapFile(&file);
+    writeDecodedCache(DIR_CACHE_TILE, key, TILE_VARIETY * TILE_SIZE
+        * TILE_SIZE, gpTilePixels);
     
     return ERROR_SUCCESS;
+}
+
+/*
+ * The "classifyTileOpacity" function returns the opacity of a tile whose
+ * opaque spans are built. Tiles without any span are transparent, and
+ * tiles whose every row is a single span as wide as them are opaque.
+ */
+
+__forceinline UINT8 classifyTileOpacity(
+        const sSpanImage* const restrict pTile) {
+
+    if (pTile->pRowSpans[pTile->height] == 0) {
+        return opacityTransparent;
+    }
+    for (UINT8 row = 0; row < pTile->height; row++) {
+        if (pTile->pRowSpans[row + 1] - pTile->pRowSpans[row] != 1
+                || pTile->pSpans[pTile->pRowSpans[row]].length
+                    != pTile->width) {
+            return opacityMixed;
+        }
+    }
+    return opacityOpaque;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "coordinator.h"
+#include "management_bundle.h"
+#include "prop_bundle.h"
 #include "prop_dir.h"
 
 /*
@@ -24,36 +26,44 @@ __forceinline void freeTilemap();
 
 __forceinline LRESULT initLevel() {
     
-    FILE* pFile = fopen(DIR_FIRST_LEVEL, "rb");
-    if (pFile == NULL) {
+    sMappedFile file;
+    if (mapAsset(ASSET_LEVEL, 0, DIR_FIRST_LEVEL, &file) != ERROR_SUCCESS) {
         panic("Entry level file was not found.");
         return ERROR_FILE_NOT_FOUND;
     }
+    if (file.size < 2) {
+        unmapFile(&file);
+        panic("Entry level file is truncated.");
+        return ERROR_INVALID_DATA;
+    }
     // This variable stores the second part of the 12-bit value used to
     // describe the width of the level in tiles.
-    BYTE levelWidthPieceLow;
-    const UINT levelColumns = ((fgetc(pFile) << 4) 
-        + ((levelWidthPieceLow = fgetc(pFile)) >> 4));
+    BYTE levelWidthPieceLow = file.pData[1];
+    const UINT levelColumns = ((file.pData[0] << 4) 
+        + (levelWidthPieceLow >> 4));
     const UINT levelTileRawBytes = levelColumns * COLUMN_SIZE;
     const UINT levelTileAlignedBytes = levelTileRawBytes / 8
         + ((levelTileRawBytes % 8) != 0);
     // Save the boundary that the player character cannot pass beyond for the
     // number of columns of the level read from the level file.
     gLevel.width = levelColumns * TILE_SIZE;
-    BYTE* pRawLevelBytes = malloc(levelTileAlignedBytes);
-    if (pRawLevelBytes == NULL) {
-        panic("Temporary raw level data memory allocation failed.");
-        return ERROR_NOT_ENOUGH_MEMORY;
+    // The raw level data follows the first two bytes of the level file. It
+    // is read directly from the mapping.
+    if (file.size - 2 < levelTileAlignedBytes) {
+        unmapFile(&file);
+        panic("Entry level file is truncated.");
+        return ERROR_INVALID_DATA;
     }
-    // At this point, the first two bytes of the level file were read.
-    fread(pRawLevelBytes, levelTileAlignedBytes, 1, pFile);
-    fclose(pFile);
+    const BYTE* const pRawLevelBytes = file.pData + 2;
     // The size of the allocated memory for the tilemap corresponds to the
     // number of bits used in the level file used to describe the level
-    // layout.
+    // layout. The translation below also writes the padding bits of the
+    // last byte, alongside the four bits read from the second byte of the
+    // level file, for which room is reserved.
     BYTE* pTilemap = (
-        gLevel.pTilemap = malloc(levelColumns * COLUMN_SIZE));
+        gLevel.pTilemap = malloc(levelTileAlignedBytes * 8 + 4));
     if (pTilemap == NULL) {
+        unmapFile(&file);
         panic("Tilemap memory allocation failed.");
         return ERROR_NOT_ENOUGH_MEMORY;
     }
@@ -150,7 +160,7 @@ __forceinline LRESULT initLevel() {
         bits = 0;
     }
     
-    free(pRawLevelBytes);
+    unmapFile(&file);
     return ERROR_SUCCESS;
 }
 
@@ -0,0 +1,130 @@
+// This code is designed to be compiled with GCC.
+// The packing tool must be executed from the directory containing the
+// "user" directory. It writes the asset bundle to the directory described
+// by the "DIR_BUNDLE" macro, unless another output directory is passed as
+// the first argument.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "encode.h"
+#include "prop_dir.h"
+#include "prop_bundle.h"
+#include "prop_character.h"
+
+/*
+ * This section establishes data structures used throughout this file, and no
+ * other program.
+ */
+
+// The struct below describes an asset to pack. Its contents are read from
+// the directory it features.
+typedef struct {
+    uint8_t type;
+    uint8_t id;
+    const char* pDir;
+    uint8_t* pContents;
+    uint32_t size;
+} sPackedAsset;
+
+/*
+ * This section establishes and outlines function symbols used thoughout
+ * this program.
+ */
+
+void writeLittleEndian(
+    FILE* const restrict pFile,
+    uint32_t value,
+    const uint8_t bytes);
+
+/*
+ * The function below is the entry point to the packing tool. It reads every
+ * asset of the "user" directory, then writes the bundle header, its index
+ * and the contents of all assets in the order of the index.
+ */
+
+int main(int argc, char** argv) {
+
+    const char* dirPixelData[] = generateCharacterArray(bitmapDirOf);
+    const char* dirMold[] = generateCharacterArray(moldDirOf);
+    const uint8_t characterVariety = sizeof(dirMold) / sizeof(dirMold[0]);
+
+    sPackedAsset assets[4 + 2 * (sizeof(dirMold) / sizeof(dirMold[0]))] = {
+        {ASSET_LEVEL, 0, DIR_FIRST_LEVEL, NULL, 0},
+        {ASSET_GEN, 0, DIR_FIRST_GEN, NULL, 0},
+        {ASSET_TILE, 0, DIR_TILE, NULL, 0},
+        {ASSET_BACKGROUND, 0, DIR_BACKGROUND, NULL, 0},
+    };
+    uint16_t entries = 4;
+    // Character molds and graphics are identified by their mold identifier,
+    // which is their position in the character array.
+    for (uint8_t moldId = 0; moldId < characterVariety; moldId++) {
+        assets[entries++] = (sPackedAsset) {
+            ASSET_MOLD, moldId, dirMold[moldId], NULL, 0};
+        assets[entries++] = (sPackedAsset) {
+            ASSET_CHARACTER_GRAPHIC, moldId, dirPixelData[moldId], NULL, 0};
+    }
+
+    for (uint16_t i = 0; i < entries; i++) {
+        assets[i].pContents = readFile(assets[i].pDir, &assets[i].size);
+        if (assets[i].pContents == NULL) {
+            fprintf(stderr, "Asset %s could not be read.\n", assets[i].pDir);
+            return EXIT_FAILURE;
+        }
+    }
+
+    const char* const pOutputDir = argc > 1 ? argv[1] : DIR_BUNDLE;
+    FILE* const pFile = fopen(pOutputDir, "wb");
+    if (pFile == NULL) {
+        fprintf(stderr, "Bundle %s could not be created.\n", pOutputDir);
+        return EXIT_FAILURE;
+    }
+
+    fwrite(BUNDLE_MAGIC, 1, 4, pFile);
+    writeLittleEndian(pFile, BUNDLE_VERSION, 1);
+    writeLittleEndian(pFile, 0, 1);
+    writeLittleEndian(pFile, entries, 2);
+
+    // Asset contents are stored immediately after the index, in the order
+    // of their entries.
+    uint32_t offset = BUNDLE_HEADER_BYTES + entries * BUNDLE_ENTRY_BYTES;
+    for (uint16_t i = 0; i < entries; i++) {
+        writeLittleEndian(pFile, assets[i].type, 1);
+        writeLittleEndian(pFile, assets[i].id, 1);
+        writeLittleEndian(pFile, 0, 2);
+        writeLittleEndian(pFile, offset, 4);
+        writeLittleEndian(pFile, assets[i].size, 4);
+        offset += assets[i].size;
+    }
+    for (uint16_t i = 0; i < entries; i++) {
+        fwrite(assets[i].pContents, 1, assets[i].size, pFile);
+        free(assets[i].pContents);
+    }
+
+    if (fclose(pFile) != 0) {
+        fprintf(stderr, "Bundle %s could not be written.\n", pOutputDir);
+        return EXIT_FAILURE;
+    }
+    printf("Packed %u assets in %s (%u bytes).\n", entries, pOutputDir,
+        offset);
+    return EXIT_SUCCESS;
+}
+
+/*
+ * The "writeLittleEndian" function writes the passed number of the least
+ * significant bytes of a value, from the least to the most significant one.
+ */
+
+void writeLittleEndian(
+        FILE* const restrict pFile,
+        uint32_t value,
+        const uint8_t bytes) {
+
+    for (uint8_t i = 0; i < bytes; i++) {
+        fputc(value & 0xFF, pFile);
+        value >>= 8;
+    }
+    return;
+}
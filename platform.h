@@ -0,0 +1,50 @@
+#pragma once
+
+#include "coordinator.h"
+
+/*
+ * The functions declared in this file are the interface between the game
+ * and the platform it runs on. The platform opens a window and the
+ * backbuffer, describes the keyboard by a snapshot taken before every game
+ * update, sleeps to pace game updates, writes debug text and presents the
+ * backbuffer on the window. Windows presents through the GDI, and other
+ * platforms through shared memory images of the X window system. Timestamps
+ * are read by the "queryMicroseconds" function of the "task.h" file, which
+ * is portable already.
+ */
+
+// The struct below describes the resources that the process uses, as
+// displayed by the debug interface.
+typedef struct {
+    UINT8 processHandleCount;
+    UINT8 cpuPercent;
+    USHORT ramKb;
+    USHORT pagefileKb;
+    USHORT fps;
+} sPerformanceStatistics;
+
+__forceinline LRESULT openPlatform();
+
+__forceinline BOOLEAN pollPlatform(sInput* const restrict pInput);
+
+__forceinline void sleepPlatform(const UINT32 microseconds);
+
+__forceinline void samplePlatform(
+    sPerformanceStatistics* const restrict pStatistics,
+    const UINT32 microseconds);
+
+__forceinline void writePlatformText(
+    const UINT16 x,
+    const UINT16 y,
+    const CHAR* const restrict pText,
+    const UINT8 length);
+
+__forceinline void presentPlatform();
+
+__forceinline LRESULT closePlatform();
+
+#ifdef _WIN32
+#include "platform_win32.h"
+#else
+#include "platform_x11.h"
+#endif
\ No newline at end of file
@@ -0,0 +1,472 @@
+#pragma once
+
+#include <windows.h>
+#include <psapi.h>
+
+#include "coordinator.h"
+#include "prop_render.h"
+#include "render_upscale.h"
+
+/*
+ * The functions of this file implement the platform interface with the
+ * Windows API. The backbuffer is a device independent bitmap, and debug
+ * text is written on it by the GDI with a font of fixed width. It is scaled
+ * up on another bitmap the size of a borderless window covering the
+ * primary monitor, which is copied on the window as it is. Window messages are
+ * handled one at a time, before every game update, and the keyboard is read
+ * by the "GetKeyState" function. A named mutex ensures that a single
+ * instance of the application runs at a time.
+ */
+
+// The bit below is set in the secondary parameter of key messages repeated
+// while the key is held.
+#define KEY_REPEAT_BIT (1 << 30)
+
+// The struct below holds the resources of the platform. The destination
+// device context is the window's pixels that are displayed on the monitor
+// if this window is in view, while the source device context is the
+// backbuffer's pixel data. The window device context holds the pixel data
+// of the scaled backbuffer. The last message handled describes whether the
+// window is in focus.
+typedef struct {
+    HANDLE processHandle;
+    HDC destinationDc;
+    HDC sourceDc;
+    HDC windowDc;
+    HBITMAP windowBitmapHandle;
+    sUpscaleTarget upscaleTarget;
+    HFONT debugFontHandle;
+    MSG message;
+    DWORD processors;
+    INT64 kernelCPUTime;
+    INT64 userCPUTime;
+} sPlatform;
+
+__forceinline LRESULT spawnWindow(HINSTANCE instance);
+
+__forceinline LRESULT mainWndProc(
+    HWND handle,
+    UINT32 id,
+    WPARAM primary,
+    LPARAM secondary);
+
+__forceinline LRESULT initBackbuffer();
+
+__forceinline LRESULT initWindowBuffer();
+
+__forceinline HBITMAP createPixelBitmap(
+    const UINT16 width,
+    const UINT16 height,
+    void** const restrict ppPixels);
+
+HWND gWindowHandle;
+sPlatform gPlatform;
+
+/*
+ * The "openPlatform" function creates the window and the backbuffer, and
+ * prepares the device contexts and the font used to present it. The
+ * application fails to open if another instance of it runs, which is
+ * detected by the creation of its mutex. This mutex need not be saved,
+ * since it is not needed for any future reference.
+ */
+
+__forceinline LRESULT openPlatform() {
+
+    CreateMutex(NULL, FALSE, MUTEX_TITLE);
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        return ERROR_ALREADY_EXISTS;
+    }
+    LRESULT result;
+    if ((result = spawnWindow(GetModuleHandle(NULL))) != ERROR_SUCCESS
+            || (result = initBackbuffer()) != ERROR_SUCCESS
+            || (result = initWindowBuffer()) != ERROR_SUCCESS) {
+        return result;
+    }
+
+    // The handle to the process in which this program is executing is used
+    // to retrieve performance statistics about the process. This handle
+    // does not need to be subjected to a closing or termination operation.
+    gPlatform.processHandle = GetCurrentProcess();
+    // The priority level of the current process should be high. This process
+    // is time-critical because the update frequency must be as constant as
+    // possible.
+    if (SetPriorityClass(gPlatform.processHandle, HIGH_PRIORITY_CLASS) == 0) {
+        panic("Modification of process priority level failed.");
+    }
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    gPlatform.processors = systemInfo.dwNumberOfProcessors;
+
+    gPlatform.destinationDc = GetDC(gWindowHandle);
+    gPlatform.sourceDc = CreateCompatibleDC(gPlatform.destinationDc);
+    SelectObject(gPlatform.sourceDc, gBackbuffer.bitmapHandle);
+    gPlatform.windowDc = CreateCompatibleDC(gPlatform.destinationDc);
+    SelectObject(gPlatform.windowDc, gPlatform.windowBitmapHandle);
+
+    // Select the custom font into the device context of the newly created
+    // window.
+    gPlatform.debugFontHandle = CreateFont(
+        DEBUG_CHAR_HEIGHT,
+        DEBUG_CHAR_WIDTH,
+        0,
+        0,
+        FW_REGULAR, // font weight
+        FALSE, // italics
+        FALSE, // underlined
+        FALSE, // strikethrough
+        ANSI_CHARSET,
+        OUT_DEFAULT_PRECIS,
+        CLIP_DEFAULT_PRECIS,
+        NONANTIALIASED_QUALITY,
+        FF_MODERN | DEFAULT_PITCH,
+        NULL); // Font name
+
+    SelectObject(
+        gPlatform.sourceDc,
+        gPlatform.debugFontHandle
+    );
+
+    // Increase accuracy of the Windows timer resolution in order make the
+    // application's thread sleep for more precise intervals of time when
+    // calling the "Sleep" function.
+    if (timeBeginPeriod(MINIMUM_TIME_RESOLUTION) == TIMERR_NOCANDO) {
+        panic("Denied change of the Windows timer resolution.");
+    }
+    return ERROR_SUCCESS;
+}
+
+/*
+ * This function creates a window with its main procedure function set to the
+ * "mainWndProc" function. This window bears minimize, maximize, and close
+ * buttons, and a title defined in the "prop.h" header.
+ */
+
+__forceinline LRESULT spawnWindow(HINSTANCE handleInstance) {
+
+    WNDCLASSEX windowClass;
+
+    // Initialization of attributes of the window class to register.
+    windowClass.cbSize = sizeof(WNDCLASSEX);
+    windowClass.style = CS_HREDRAW | CS_VREDRAW;
+    windowClass.lpfnWndProc = mainWndProc;
+    windowClass.cbClsExtra = 0;
+    windowClass.cbWndExtra = 0;
+    windowClass.hInstance = handleInstance;
+    windowClass.hIcon = LoadIcon(NULL, IDI_APPLICATION);
+    windowClass.hIconSm = LoadImage(
+        handleInstance,
+        MAKEINTRESOURCE(5),
+        IMAGE_ICON,
+        GetSystemMetrics(SM_CXSMICON),
+        GetSystemMetrics(SM_CXSMICON),
+        LR_DEFAULTCOLOR);
+    windowClass.hCursor = LoadCursor(NULL, IDC_ARROW);
+    windowClass.hbrBackground = CreateSolidBrush(0xFF00FF);
+    windowClass.lpszMenuName = INNER_TITLE;
+    windowClass.lpszClassName = CLASS_TITLE;
+
+    if (!RegisterClassEx(&windowClass)) {
+        panic("Window registration failed.");
+        return ERROR_INVALID_DATA;
+    }
+
+    // Dummy values for monitor info struct
+    RECT rectangleDummy = {0};
+    // Determination of monitor information.
+    MONITORINFO monitorInfo = {
+        sizeof(MONITORINFO),
+        rectangleDummy,
+        rectangleDummy,
+        0};
+    if (GetMonitorInfo(MonitorFromWindow(gWindowHandle,
+            MONITOR_DEFAULTTOPRIMARY),
+            &monitorInfo) == 0) {
+        panic("Monitor information retrieval was unsuccessful.");
+    }
+
+    RECT rectBuffer = monitorInfo.rcMonitor;
+    const USHORT monitorWidth = (USHORT) rectBuffer.right - rectBuffer.left;
+    const USHORT monitorHeight = (USHORT) rectBuffer.bottom - rectBuffer.top;
+
+    // Save the dimensions of the window for later retrieval.
+    gWindowDimensions = (sDimensions) {
+        monitorWidth,
+        monitorHeight,
+    };
+
+    // Creation of the window that this program uses, assuming that its
+    // registration was successful. The "WS_VISIBLE" window style ensures
+    // that the created window appears, and the "WS_POPUP" window style
+    // ensures that the created window is borderless.
+    gWindowHandle = CreateWindow(
+        CLASS_TITLE,
+        DISPLAY_TITLE,
+        WS_VISIBLE | WS_POPUP,
+        rectBuffer.left,
+        rectBuffer.top,
+        monitorWidth,
+        monitorHeight,
+        NULL,
+        NULL,
+        handleInstance,
+        NULL);
+
+    if (gWindowHandle == NULL) {
+        panic("Window creation failed.");
+        return ERROR_INVALID_DATA;
+    }
+
+    return ERROR_SUCCESS;
+}
+
+LRESULT initBackbuffer() {
+    // Create the backbuffer to be scaled onto the application windows's
+    // pixels.
+    gBackbuffer.bitmapHandle = createPixelBitmap(
+        BACKBUFFER_WIDTH,
+        BACKBUFFER_HEIGHT,
+        &gBackbuffer.pPixelData);
+    if (gBackbuffer.bitmapHandle == NULL) {
+        panic("Backbuffer memory allocation failed.");
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    gBackbuffer.memorySize = (BACKBUFFER_WIDTH *
+        BACKBUFFER_HEIGHT * BYTES_PER_PIXEL);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "initWindowBuffer" function creates the bitmap the size of the window
+ * which the backbuffer is scaled up on. Its rows are stored from the bottom
+ * row upwards, like those of the backbuffer, and its borders are black.
+ */
+
+LRESULT initWindowBuffer() {
+
+    void* pWindowPixels;
+    gPlatform.windowBitmapHandle = createPixelBitmap(
+        gWindowDimensions.width,
+        gWindowDimensions.height,
+        &pWindowPixels);
+    if (gPlatform.windowBitmapHandle == NULL) {
+        panic("Window buffer memory allocation failed.");
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    if (!placeUpscaleTarget(&gPlatform.upscaleTarget, pWindowPixels,
+            gWindowDimensions.width, gWindowDimensions.width,
+            gWindowDimensions.height)) {
+        panic("The window is smaller than the backbuffer.");
+        return ERROR_INVALID_DATA;
+    }
+    clearUpscaleTarget(&gPlatform.upscaleTarget);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "createPixelBitmap" function creates a device independent bitmap of
+ * the passed dimensions, whose pixel data is saved at the passed address.
+ * The "CreateDIBSection" returns a NULL pointer if it fails to create a
+ * device independent bitmap.
+ */
+
+__forceinline HBITMAP createPixelBitmap(
+        const UINT16 width,
+        const UINT16 height,
+        void** const restrict ppPixels) {
+
+    // The "BITMAPINFO" struct is necessary when using the "CreateDIBSection"
+    // function as opposed to the "CreateBitmap" function.
+    BITMAPINFO bitmapInfo = {0};
+    bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bitmapInfo.bmiHeader.biWidth = width;
+    bitmapInfo.bmiHeader.biHeight = height;
+    bitmapInfo.bmiHeader.biBitCount = BITMAP_BPP;
+    // The symbol "BI_RGB" indicates that no compression procedure is
+    // employed.
+    bitmapInfo.bmiHeader.biCompression = BI_RGB;
+    bitmapInfo.bmiHeader.biPlanes = 1;
+    return CreateDIBSection(
+        NULL,
+        &bitmapInfo,
+        DIB_RGB_COLORS,
+        ppPixels,
+        NULL,
+        0);
+}
+
+/*
+ * This function is the main procedure for the window generated by the
+ * "spawnWindow" function.
+ */
+
+LRESULT mainWndProc(HWND handle, UINT32 messageId, WPARAM primary,
+    LPARAM secondary) {
+    switch(messageId) {
+        case WM_CLOSE:
+            PostQuitMessage(0);
+            break;
+        case WM_ACTIVATE:
+            ShowCursor(FALSE);
+            break;
+        default:
+            return DefWindowProc(handle, messageId, primary, secondary);
+    }
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "pollPlatform" function handles the next window message, if any, and
+ * takes a snapshot of the keyboard in the passed input. Letters pressed
+ * along the control key are only reported once, rather than for every key
+ * message repeated while they are held. FALSE is returned once the
+ * application is requested to quit.
+ */
+
+__forceinline BOOLEAN pollPlatform(sInput* const restrict pInput) {
+
+    MSG* const pMessage = &gPlatform.message;
+    pInput->controlKey = 0;
+    if (PeekMessage(pMessage, gWindowHandle, 0, 0, PM_NOREMOVE)) {
+        if (GetAsyncKeyState(VK_CONTROL) && pMessage->message == WM_KEYDOWN
+                && !(pMessage->lParam & KEY_REPEAT_BIT)) {
+            pInput->controlKey = (CHAR) pMessage->wParam;
+        }
+        if (GetMessage(pMessage, NULL, 0, 0) <= 0) {
+            return FALSE;
+        }
+        DispatchMessage(pMessage);
+    }
+    pInput->isInFocus = pMessage->message == WM_ACTIVATE
+        || pMessage->wParam != 0;
+    pInput->isLeftDown = (GetKeyState(VK_LEFT) & 0x80) != 0;
+    pInput->isRightDown = (GetKeyState(VK_RIGHT) & 0x80) != 0;
+    pInput->isJumpDown = (GetKeyState(VK_SPACE) & 0x80) != 0;
+    pInput->isRunDown = (GetKeyState('X') & 0x80) != 0;
+    return TRUE;
+}
+
+/*
+ * The "sleepPlatform" function suspends the calling thread for about the
+ * passed number of microseconds, to the millisecond.
+ */
+
+__forceinline void sleepPlatform(const UINT32 microseconds) {
+    Sleep(microseconds / 1000);
+    return;
+}
+
+/*
+ * The "samplePlatform" function saves in the passed statistics the
+ * resources that the process uses. The CPU usage is averaged over the
+ * passed number of microseconds since the previous sample.
+ */
+
+__forceinline void samplePlatform(
+        sPerformanceStatistics* const restrict pStatistics,
+        const UINT32 microseconds) {
+
+    // The command below is needed to save the number of handles that
+    // the process in which executes this application is featuring.
+    // The retrieval of this handle number is saved to a buffer whose
+    // size matches that of the pointer's datum required in the call
+    // of the "GetProcessHandleCount" function.
+    DWORD bufferHandleCount;
+    GetProcessHandleCount(
+        gPlatform.processHandle,
+        &bufferHandleCount);
+    pStatistics->processHandleCount = (BYTE) bufferHandleCount;
+
+    // The commands below saves the amount of memory, regardless of
+    // type, that the process in which this application runs in
+    // is allocated to.
+    PROCESS_MEMORY_COUNTERS tempMemCounter;
+    GetProcessMemoryInfo(
+        gPlatform.processHandle,
+        &tempMemCounter,
+        sizeof(PROCESS_MEMORY_COUNTERS));
+
+    pStatistics->ramKb = (USHORT) (tempMemCounter.WorkingSetSize / 1000);
+    pStatistics->pagefileKb = (USHORT) (tempMemCounter.PagefileUsage / 1000);
+
+    // The commands below determine the CPU usage times for every
+    // complete sampling. The dummy variable declared and defined
+    // below is used to satisfy the input requirements of the call
+    // to the "GetProcessTimes" function.
+    INT64 kernelCPUTimeCurrent, userCPUTimeCurrent;
+    FILETIME dummyTime;
+    GetProcessTimes(
+        gPlatform.processHandle,
+        &dummyTime,
+        &dummyTime,
+        (FILETIME*) &kernelCPUTimeCurrent,
+        (FILETIME*) &userCPUTimeCurrent);
+
+    pStatistics->cpuPercent = ((kernelCPUTimeCurrent + userCPUTimeCurrent)
+        - (gPlatform.kernelCPUTime + gPlatform.userCPUTime))
+        / (gPlatform.processors * microseconds / 10);
+
+    // Update both CPU usage times by the kernel and the user to their
+    // current usage times.
+    gPlatform.kernelCPUTime = kernelCPUTimeCurrent;
+    gPlatform.userCPUTime = userCPUTimeCurrent;
+    return;
+}
+
+/*
+ * The "writePlatformText" function writes the passed text on the
+ * backbuffer, from the passed coordinates of its top-left corner.
+ */
+
+__forceinline void writePlatformText(
+        const UINT16 x,
+        const UINT16 y,
+        const CHAR* const restrict pText,
+        const UINT8 length) {
+    TextOut(gPlatform.sourceDc, x, y, pText, length);
+    return;
+}
+
+/*
+ * The "presentPlatform" function scales the backbuffer up on the window
+ * buffer, and copies the window buffer on the window. The GDI neither
+ * stretches nor filters the copy.
+ */
+
+__forceinline void presentPlatform() {
+    upscaleBackbuffer(&gPlatform.upscaleTarget, gBackbuffer.pPixelData);
+    if (BitBlt(
+            gPlatform.destinationDc,
+            0,
+            0,
+            gWindowDimensions.width,
+            gWindowDimensions.height,
+            gPlatform.windowDc,
+            0,
+            0,
+            SRCCOPY) == 0) {
+        panic("Backbuffer copy to window failed.");
+    }
+    return;
+}
+
+/*
+ * The "closePlatform" function releases the device contexts, the font, the
+ * window buffer and the backbuffer. Window objects cannot be deleted.
+ */
+
+__forceinline LRESULT closePlatform() {
+
+    DeleteDC(gPlatform.windowDc);
+    DeleteObject(gPlatform.windowBitmapHandle);
+    DeleteDC(gPlatform.sourceDc);
+    ReleaseDC(gWindowHandle, gPlatform.destinationDc);
+    DeleteObject(gPlatform.debugFontHandle);
+    // The timer resolution set used throughout this application is no longer
+    // required and can be reinstated to its original value.
+    timeEndPeriod(MINIMUM_TIME_RESOLUTION);
+    if (DeleteObject(gBackbuffer.bitmapHandle) == 0) {
+        panic("Handle to backbuffer pixel data was unsuccessfully deleted.");
+        return ERROR_INVALID_PARAMETER;
+    }
+    return ERROR_SUCCESS;
+}
\ No newline at end of file
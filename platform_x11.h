@@ -0,0 +1,539 @@
+#pragma once
+
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/XKBlib.h>
+#include <X11/keysym.h>
+#include <X11/extensions/XShm.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/ipc.h>
+#include <sys/resource.h>
+#include <sys/shm.h>
+
+#include "coordinator.h"
+#include "prop_render.h"
+#include "render_upscale.h"
+
+/*
+ * The functions of this file implement the platform interface with the X
+ * window system, on platforms other than Windows. The backbuffer is plain
+ * memory, which is scaled up on an image of the window every frame. The
+ * window is the backbuffer scaled by the largest integer factor that the
+ * screen fits, and the rows of its image are stored from the top row
+ * downwards. This image lives in memory shared with the X server through the
+ * MIT-SHM extension, such that presenting it does not send its pixels
+ * through the connection to the server. Displays without the extension, such
+ * as remote ones, are sent the pixels instead. Debug text is drawn on the
+ * window once the image is presented, with the default font of the server.
+ * The keyboard is described by the key events of the window, and a lock on a
+ * file named after the mutex of Windows ensures that a single instance of
+ * the application runs at a time.
+ */
+
+// The macro below is the number of key codes of the X window system.
+#define PLATFORM_KEY_CODES 256
+// The macro below is the number of lines of debug text that a frame writes
+// at most, which are the metrics and the debug messages.
+#define PLATFORM_TEXT_LINES (DEBUG_METRICS_LINE_SIZE \
+    + MAX_DEBUG_MESSAGE_NUMBER)
+#define PLATFORM_LOCK_PATH "/tmp/" MUTEX_TITLE
+
+// The struct below describes a line of debug text to draw once the image
+// is presented, from the coordinates of its top-left corner on the
+// backbuffer.
+typedef struct {
+    UINT16 x;
+    UINT16 y;
+    UINT8 length;
+    CHAR text[MAX_DEBUG_MESSAGE_SIZE];
+} sPlatformText;
+
+// The struct below holds the resources of the platform. Keys are down while
+// their state is set, and are indexed by their key code. The CPU time is
+// the one that the process used at the previous sample, in microseconds.
+typedef struct {
+    Display* pDisplay;
+    Window window;
+    GC context;
+    Cursor cursor;
+    Atom deleteAtom;
+    XImage* pImage;
+    XShmSegmentInfo segment;
+    BOOLEAN isShared;
+    BOOLEAN isAttachFailed;
+    sUpscaleTarget upscaleTarget;
+    INT fontAscent;
+    INT lockFile;
+    BOOLEAN isInFocus;
+    BYTE keyStates[PLATFORM_KEY_CODES];
+    KeyCode leftKey;
+    KeyCode rightKey;
+    KeyCode jumpKey;
+    KeyCode runKey;
+    sPlatformText texts[PLATFORM_TEXT_LINES];
+    UINT8 textLines;
+    UINT64 cpuMicroseconds;
+} sPlatform;
+
+__forceinline LRESULT openPlatformWindow();
+
+__forceinline LRESULT openPlatformImage();
+
+int catchPlatformError(Display* pDisplay, XErrorEvent* pError);
+
+sPlatform gPlatform = {0};
+
+/*
+ * The "openPlatform" function connects to the X server, and creates the
+ * window, its image and the backbuffer. The application fails to open if
+ * another instance of it holds the lock, which is released when the
+ * process exits.
+ */
+
+__forceinline LRESULT openPlatform() {
+
+    struct flock lock = {0};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    gPlatform.lockFile = open(PLATFORM_LOCK_PATH, O_RDWR | O_CREAT, 0600);
+    if (gPlatform.lockFile == -1
+            || fcntl(gPlatform.lockFile, F_SETLK, &lock) == -1) {
+        return ERROR_ALREADY_EXISTS;
+    }
+
+    // The render thread presents frames while the main thread handles
+    // events, such that Xlib must be thread-safe.
+    if (!XInitThreads()
+            || (gPlatform.pDisplay = XOpenDisplay(NULL)) == NULL) {
+        panic("Display connection failed.");
+        return ERROR_INVALID_DATA;
+    }
+    gBackbuffer.pPixelData = calloc(BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT,
+        sizeof(sPixel));
+    if (gBackbuffer.pPixelData == NULL) {
+        panic("Backbuffer memory allocation failed.");
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    gBackbuffer.memorySize = BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT
+        * BYTES_PER_PIXEL;
+
+    LRESULT result;
+    if ((result = openPlatformWindow()) != ERROR_SUCCESS
+            || (result = openPlatformImage()) != ERROR_SUCCESS) {
+        return result;
+    }
+
+    // The window is only given the focus once it is mapped, which is
+    // awaited. Other windows may take the focus back at any time.
+    XEvent event;
+    XMapWindow(gPlatform.pDisplay, gPlatform.window);
+    do {
+        XWindowEvent(gPlatform.pDisplay, gPlatform.window,
+            StructureNotifyMask, &event);
+    } while (event.type != MapNotify);
+    XSetInputFocus(gPlatform.pDisplay, gPlatform.window, RevertToParent,
+        CurrentTime);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "openPlatformWindow" function creates a window of a fixed size, which
+ * is the backbuffer scaled by the largest integer factor that the screen
+ * fits. Its cursor is hidden, and closing it is reported as a message
+ * rather than by the connection being closed. Keys repeated while held are
+ * only reported as pressed again, rather than released and pressed again.
+ */
+
+__forceinline LRESULT openPlatformWindow() {
+
+    Display* const pDisplay = gPlatform.pDisplay;
+    const INT screen = DefaultScreen(pDisplay);
+    const Visual* const pVisual = DefaultVisual(pDisplay, screen);
+    // Pixels of the backbuffer are presented as they are, which requires
+    // the display to describe them in the same order.
+    if (pVisual->red_mask != 0xFF0000 || pVisual->green_mask != 0x00FF00
+            || pVisual->blue_mask != 0x0000FF) {
+        panic("Display format is unsupported.");
+        return ERROR_INVALID_DATA;
+    }
+
+    INT scale = DisplayWidth(pDisplay, screen) / BACKBUFFER_WIDTH;
+    const INT heightScale = DisplayHeight(pDisplay, screen)
+        / BACKBUFFER_HEIGHT;
+    if (heightScale < scale) {
+        scale = heightScale;
+    }
+    if (scale > UPSCALE_MAX_SCALE) {
+        scale = UPSCALE_MAX_SCALE;
+    } else if (scale == 0) {
+        scale = 1;
+    }
+    gWindowDimensions = (sDimensions) {
+        BACKBUFFER_WIDTH * scale,
+        BACKBUFFER_HEIGHT * scale,
+    };
+
+    XSetWindowAttributes attributes = {0};
+    attributes.background_pixel = 0xFF00FF;
+    attributes.event_mask = KeyPressMask | KeyReleaseMask | FocusChangeMask
+        | StructureNotifyMask;
+    gPlatform.window = XCreateWindow(
+        pDisplay,
+        RootWindow(pDisplay, screen),
+        0,
+        0,
+        gWindowDimensions.width,
+        gWindowDimensions.height,
+        0,
+        CopyFromParent,
+        InputOutput,
+        CopyFromParent,
+        CWBackPixel | CWEventMask,
+        &attributes);
+    XStoreName(pDisplay, gPlatform.window, DISPLAY_TITLE);
+    gPlatform.deleteAtom = XInternAtom(pDisplay, "WM_DELETE_WINDOW", False);
+    XSetWMProtocols(pDisplay, gPlatform.window, &gPlatform.deleteAtom, 1);
+
+    XSizeHints* const pHints = XAllocSizeHints();
+    if (pHints == NULL) {
+        panic("Window creation failed.");
+        return ERROR_NOT_ENOUGH_MEMORY;
+    }
+    pHints->flags = PMinSize | PMaxSize;
+    pHints->min_width = pHints->max_width = gWindowDimensions.width;
+    pHints->min_height = pHints->max_height = gWindowDimensions.height;
+    XSetWMNormalHints(pDisplay, gPlatform.window, pHints);
+    XFree(pHints);
+
+    // The cursor is an empty bitmap.
+    const CHAR emptyBits[1] = {0};
+    XColor black = {0};
+    const Pixmap emptyPixmap = XCreateBitmapFromData(pDisplay,
+        gPlatform.window, emptyBits, 1, 1);
+    gPlatform.cursor = XCreatePixmapCursor(pDisplay, emptyPixmap,
+        emptyPixmap, &black, &black, 0, 0);
+    XFreePixmap(pDisplay, emptyPixmap);
+    XDefineCursor(pDisplay, gPlatform.window, gPlatform.cursor);
+
+    // Debug text is black on white, like the text written by the GDI.
+    gPlatform.context = XCreateGC(pDisplay, gPlatform.window, 0, NULL);
+    XSetForeground(pDisplay, gPlatform.context, BlackPixel(pDisplay, screen));
+    XSetBackground(pDisplay, gPlatform.context, WhitePixel(pDisplay, screen));
+    XFontStruct* const pFont = XQueryFont(pDisplay,
+        XGContextFromGC(gPlatform.context));
+    if (pFont != NULL) {
+        gPlatform.fontAscent = pFont->ascent;
+        XFreeFontInfo(NULL, pFont, 1);
+    }
+
+    XkbSetDetectableAutoRepeat(pDisplay, True, NULL);
+    gPlatform.leftKey = XKeysymToKeycode(pDisplay, XK_Left);
+    gPlatform.rightKey = XKeysymToKeycode(pDisplay, XK_Right);
+    gPlatform.jumpKey = XKeysymToKeycode(pDisplay, XK_space);
+    gPlatform.runKey = XKeysymToKeycode(pDisplay, XK_x);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "openPlatformImage" function creates the image of the window. It is
+ * shared with the X server if the extension is supported and the segment
+ * of shared memory can be attached, which fails on remote displays. The
+ * segment is removed once attached, such that it is freed once both
+ * processes detach from it, even if this one crashes.
+ */
+
+__forceinline LRESULT openPlatformImage() {
+
+    Display* const pDisplay = gPlatform.pDisplay;
+    const INT screen = DefaultScreen(pDisplay);
+    Visual* const pVisual = DefaultVisual(pDisplay, screen);
+    const UINT depth = DefaultDepth(pDisplay, screen);
+    XShmSegmentInfo* const pSegment = &gPlatform.segment;
+
+    if (XShmQueryExtension(pDisplay)) {
+        gPlatform.pImage = XShmCreateImage(pDisplay, pVisual, depth,
+            ZPixmap, NULL, pSegment, gWindowDimensions.width,
+            gWindowDimensions.height);
+    }
+    if (gPlatform.pImage != NULL) {
+        pSegment->shmid = shmget(IPC_PRIVATE, gPlatform.pImage->bytes_per_line
+            * gPlatform.pImage->height, IPC_CREAT | 0600);
+        pSegment->shmaddr = pSegment->shmid == -1 ? (CHAR*) -1
+            : shmat(pSegment->shmid, NULL, 0);
+        if (pSegment->shmaddr != (CHAR*) -1) {
+            gPlatform.pImage->data = pSegment->shmaddr;
+            pSegment->readOnly = False;
+            // Errors of the X server are otherwise fatal.
+            XSync(pDisplay, False);
+            int (*pHandler)(Display*, XErrorEvent*) = XSetErrorHandler(
+                catchPlatformError);
+            XShmAttach(pDisplay, pSegment);
+            XSync(pDisplay, False);
+            XSetErrorHandler(pHandler);
+            gPlatform.isShared = !gPlatform.isAttachFailed;
+            if (!gPlatform.isShared) {
+                shmdt(pSegment->shmaddr);
+            }
+        }
+        if (pSegment->shmid != -1) {
+            shmctl(pSegment->shmid, IPC_RMID, NULL);
+        }
+        if (!gPlatform.isShared) {
+            gPlatform.pImage->data = NULL;
+            XDestroyImage(gPlatform.pImage);
+            gPlatform.pImage = NULL;
+        }
+    }
+    if (gPlatform.pImage == NULL) {
+        CHAR* const pData = malloc(gWindowDimensions.width
+            * gWindowDimensions.height * sizeof(sPixel));
+        if (pData != NULL) {
+            gPlatform.pImage = XCreateImage(pDisplay, pVisual, depth, ZPixmap,
+                0, pData, gWindowDimensions.width, gWindowDimensions.height,
+                BITMAP_BPP, 0);
+        }
+        if (gPlatform.pImage == NULL) {
+            free(pData);
+            panic("Window image memory allocation failed.");
+            return ERROR_NOT_ENOUGH_MEMORY;
+        }
+    }
+    XImage* const pImage = gPlatform.pImage;
+    if (pImage->bits_per_pixel != BITMAP_BPP
+            || pImage->byte_order != LSBFirst) {
+        panic("Display format is unsupported.");
+        return ERROR_INVALID_DATA;
+    }
+    const INT32 stride = pImage->bytes_per_line / sizeof(sPixel);
+    placeUpscaleTarget(&gPlatform.upscaleTarget,
+        (sPixel*) pImage->data + (pImage->height - 1) * stride, -stride,
+        gWindowDimensions.width, gWindowDimensions.height);
+    clearUpscaleTarget(&gPlatform.upscaleTarget);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "catchPlatformError" function is the error handler of the X server
+ * while the segment of shared memory is attached. It records that the
+ * segment could not be attached.
+ */
+
+int catchPlatformError(
+        __attribute__ ((unused)) Display* pDisplay,
+        __attribute__ ((unused)) XErrorEvent* pError) {
+    gPlatform.isAttachFailed = TRUE;
+    return 0;
+}
+
+/*
+ * The "pollPlatform" function handles every pending event of the window,
+ * and takes a snapshot of the keyboard in the passed input. Keys are
+ * released when the window loses the focus, since their events are then
+ * sent to another window. Letters pressed along the control key are only
+ * reported once, rather than for every key event repeated while they are
+ * held. FALSE is returned once the application is requested to quit.
+ */
+
+__forceinline BOOLEAN pollPlatform(sInput* const restrict pInput) {
+
+    Display* const pDisplay = gPlatform.pDisplay;
+    XEvent event;
+    KeySym symbol;
+    pInput->controlKey = 0;
+    while (XPending(pDisplay) > 0) {
+        XNextEvent(pDisplay, &event);
+        switch (event.type) {
+            case KeyPress:
+            symbol = XLookupKeysym(&event.xkey, 0);
+            if (!gPlatform.keyStates[event.xkey.keycode]
+                    && event.xkey.state & ControlMask
+                    && symbol >= XK_a && symbol <= XK_z) {
+                pInput->controlKey = 'A' + (symbol - XK_a);
+            }
+            gPlatform.keyStates[event.xkey.keycode] = TRUE;
+            break;
+
+            case KeyRelease:
+            gPlatform.keyStates[event.xkey.keycode] = FALSE;
+            break;
+
+            case FocusIn:
+            gPlatform.isInFocus = TRUE;
+            break;
+
+            case FocusOut:
+            gPlatform.isInFocus = FALSE;
+            memset(gPlatform.keyStates, FALSE, sizeof(gPlatform.keyStates));
+            break;
+
+            case ClientMessage:
+            if ((Atom) event.xclient.data.l[0] == gPlatform.deleteAtom) {
+                PostQuitMessage(0);
+            }
+            break;
+        }
+    }
+    pInput->isInFocus = gPlatform.isInFocus;
+    pInput->isLeftDown = gPlatform.keyStates[gPlatform.leftKey];
+    pInput->isRightDown = gPlatform.keyStates[gPlatform.rightKey];
+    pInput->isJumpDown = gPlatform.keyStates[gPlatform.jumpKey];
+    pInput->isRunDown = gPlatform.keyStates[gPlatform.runKey];
+    return !gIsQuitPosted;
+}
+
+/*
+ * The "sleepPlatform" function suspends the calling thread for about the
+ * passed number of microseconds.
+ */
+
+__forceinline void sleepPlatform(const UINT32 microseconds) {
+
+    const struct timespec duration = {
+        microseconds / 1000000,
+        microseconds % 1000000 * 1000,
+    };
+    nanosleep(&duration, NULL);
+    return;
+}
+
+/*
+ * The "samplePlatform" function saves in the passed statistics the
+ * resources that the process uses. The CPU usage is averaged over the
+ * passed number of microseconds since the previous sample. The resident
+ * memory stands for the working set of Windows, and the private data for
+ * its pagefile usage. Handles are the open file descriptors. Statistics
+ * that the "/proc" file system does not describe are left as they are.
+ */
+
+__forceinline void samplePlatform(
+        sPerformanceStatistics* const restrict pStatistics,
+        const UINT32 microseconds) {
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    const UINT64 cpuMicroseconds = (UINT64) (usage.ru_utime.tv_sec
+        + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec
+        + usage.ru_stime.tv_usec;
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    pStatistics->cpuPercent = (cpuMicroseconds - gPlatform.cpuMicroseconds)
+        * 100 / ((UINT64) systemInfo.dwNumberOfProcessors * microseconds);
+    gPlatform.cpuMicroseconds = cpuMicroseconds;
+
+    // The file below lists the total, resident, shared, text, library and
+    // data pages of the process.
+    unsigned long pages[6];
+    FILE* const pFile = fopen("/proc/self/statm", "r");
+    if (pFile != NULL) {
+        if (fscanf(pFile, "%lu %lu %lu %lu %lu %lu", &pages[0], &pages[1],
+                &pages[2], &pages[3], &pages[4], &pages[5]) == 6) {
+            const long pageSize = sysconf(_SC_PAGESIZE);
+            pStatistics->ramKb = (USHORT) (pages[1] * pageSize / 1000);
+            pStatistics->pagefileKb = (USHORT) (pages[5] * pageSize / 1000);
+        }
+        fclose(pFile);
+    }
+
+    // The directory below lists the file descriptors of the process, along
+    // with the current and parent directories and the one of the directory
+    // stream reading it.
+    DIR* const pDirectory = opendir("/proc/self/fd");
+    if (pDirectory != NULL) {
+        UINT32 entries = 0;
+        while (readdir(pDirectory) != NULL) {
+            entries++;
+        }
+        closedir(pDirectory);
+        pStatistics->processHandleCount = (BYTE) (entries - 3);
+    }
+    return;
+}
+
+/*
+ * The "writePlatformText" function saves the passed text to be drawn on
+ * the window once the image is presented, from the passed coordinates of
+ * its top-left corner on the backbuffer. Text past the maximum number of
+ * lines or their maximum size is dropped.
+ */
+
+__forceinline void writePlatformText(
+        const UINT16 x,
+        const UINT16 y,
+        const CHAR* const restrict pText,
+        const UINT8 length) {
+
+    if (gPlatform.textLines == PLATFORM_TEXT_LINES) {
+        return;
+    }
+    sPlatformText* const pLine = &gPlatform.texts[gPlatform.textLines++];
+    pLine->x = x;
+    pLine->y = y;
+    pLine->length = length < MAX_DEBUG_MESSAGE_SIZE ? length
+        : MAX_DEBUG_MESSAGE_SIZE;
+    memcpy(pLine->text, pText, pLine->length);
+    return;
+}
+
+/*
+ * The "presentPlatform" function scales the backbuffer up on the image of
+ * the window, and presents it along with the saved debug text, whose
+ * coordinates are scaled alike. The function returns once the X server has
+ * read the image, which is only written again by the next frame.
+ */
+
+__forceinline void presentPlatform() {
+
+    Display* const pDisplay = gPlatform.pDisplay;
+    XImage* const pImage = gPlatform.pImage;
+    const sUpscaleTarget* const pTarget = &gPlatform.upscaleTarget;
+    upscaleBackbuffer(pTarget, gBackbuffer.pPixelData);
+
+    if (gPlatform.isShared) {
+        XShmPutImage(pDisplay, gPlatform.window, gPlatform.context, pImage,
+            0, 0, 0, 0, gWindowDimensions.width, gWindowDimensions.height,
+            False);
+    } else {
+        XPutImage(pDisplay, gPlatform.window, gPlatform.context, pImage,
+            0, 0, 0, 0, gWindowDimensions.width, gWindowDimensions.height);
+    }
+    const sPlatformText* pLine;
+    const UINT8 scale = pTarget->scale;
+    const UINT16 top = pTarget->height - pTarget->bottom
+        - BACKBUFFER_HEIGHT * scale;
+    for (UINT8 i = 0; i < gPlatform.textLines; i++) {
+        pLine = &gPlatform.texts[i];
+        XDrawImageString(pDisplay, gPlatform.window, gPlatform.context,
+            pTarget->left + pLine->x * scale,
+            top + pLine->y * scale + gPlatform.fontAscent,
+            pLine->text, pLine->length);
+    }
+    gPlatform.textLines = 0;
+    XSync(pDisplay, False);
+    return;
+}
+
+/*
+ * The "closePlatform" function releases the image, the window and the
+ * backbuffer, closes the connection to the X server and releases the
+ * lock.
+ */
+
+__forceinline LRESULT closePlatform() {
+
+    Display* const pDisplay = gPlatform.pDisplay;
+    if (gPlatform.isShared) {
+        XShmDetach(pDisplay, &gPlatform.segment);
+        XSync(pDisplay, False);
+        shmdt(gPlatform.segment.shmaddr);
+        gPlatform.pImage->data = NULL;
+    }
+    XDestroyImage(gPlatform.pImage);
+    XFreeCursor(pDisplay, gPlatform.cursor);
+    XFreeGC(pDisplay, gPlatform.context);
+    XDestroyWindow(pDisplay, gPlatform.window);
+    XCloseDisplay(pDisplay);
+    free(gBackbuffer.pPixelData);
+    close(gPlatform.lockFile);
+    return ERROR_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+/*
+ * The definitions of this file stand in for the Windows headers on other
+ * platforms, such that the platform-independent parts of this application
+ * compile there unchanged. They only cover the types, constants and
+ * functions that these parts use. Threads are POSIX threads, events pair a
+ * mutex with a condition variable, message boxes are printed on the
+ * standard error stream, and quitting is requested through a flag.
+ */
+
+// Types of the Windows headers used by platform-independent files.
+typedef uint8_t UINT8, BYTE, BOOLEAN, UCHAR;
+typedef int8_t INT8;
+typedef char CHAR;
+typedef uint16_t UINT16, USHORT, WORD;
+typedef int16_t INT16, SHORT;
+typedef uint32_t UINT32, UINT, DWORD, ULONG;
+typedef int32_t INT32, INT, LONG, BOOL;
+typedef uint64_t UINT64, ULONGLONG;
+typedef int64_t INT64, LONGLONG;
+typedef intptr_t LRESULT;
+typedef uintptr_t UINT_PTR;
+typedef void* HANDLE;
+typedef void* HBITMAP;
+typedef void* HWND;
+typedef void* LPVOID;
+typedef const char* LPCSTR;
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID pParameter);
+typedef union {
+    struct {
+        DWORD LowPart;
+        LONG HighPart;
+    };
+    LONGLONG QuadPart;
+} LARGE_INTEGER;
+typedef struct {
+    DWORD dwNumberOfProcessors;
+} SYSTEM_INFO;
+
+#define TRUE 1
+#define FALSE 0
+#define WINAPI
+#define __cdecl
+#define __forceinline static inline __attribute__ ((always_inline))
+
+// Error codes of the Windows headers used by platform-independent files.
+#define ERROR_SUCCESS 0L
+#define ERROR_FILE_NOT_FOUND 2L
+#define ERROR_NOT_ENOUGH_MEMORY 8L
+#define ERROR_INVALID_DATA 13L
+#define ERROR_HANDLE_EOF 38L
+#define ERROR_INVALID_PARAMETER 87L
+#define ERROR_ALREADY_EXISTS 183L
+
+#define INFINITE 0xFFFFFFFF
+#define MB_OK 0x00
+#define MB_ICONEXCLAMATION 0x30
+
+// The structs below are the handles of a thread and of an event. Their
+// first member tells which of both a handle is.
+typedef struct {
+    BOOLEAN isEvent;
+    pthread_t thread;
+    LPTHREAD_START_ROUTINE pStartAddress;
+    LPVOID pParameter;
+} sPosixThread;
+
+typedef struct {
+    BOOLEAN isEvent;
+    BOOLEAN isManualReset;
+    BOOLEAN isSignaled;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition;
+} sPosixEvent;
+
+// A posted quit message sets the flag below.
+BOOLEAN gIsQuitPosted = FALSE;
+
+void* startPosixThread(void* pThread);
+
+__forceinline HANDLE CreateThread(
+    void* const pAttributes,
+    const size_t stackSize,
+    const LPTHREAD_START_ROUTINE pStartAddress,
+    const LPVOID pParameter,
+    const DWORD creationFlags,
+    DWORD* const pThreadId);
+
+__forceinline HANDLE CreateEvent(
+    void* const pAttributes,
+    const BOOL isManualReset,
+    const BOOL isInitiallySignaled,
+    const LPCSTR pName);
+
+__forceinline BOOL SetEvent(const HANDLE handle);
+
+__forceinline DWORD WaitForMultipleObjects(
+    const DWORD count,
+    const HANDLE* const pHandles,
+    const BOOL isWaitingAll,
+    const DWORD milliseconds);
+
+__forceinline DWORD WaitForSingleObject(
+    const HANDLE handle,
+    const DWORD milliseconds);
+
+__forceinline BOOL CloseHandle(const HANDLE handle);
+
+__forceinline LONG InterlockedIncrement(volatile LONG* const pAddend);
+
+__forceinline BOOL QueryPerformanceFrequency(
+    LARGE_INTEGER* const pFrequency);
+
+__forceinline BOOL QueryPerformanceCounter(LARGE_INTEGER* const pCount);
+
+__forceinline void GetSystemInfo(SYSTEM_INFO* const pSystemInfo);
+
+__forceinline INT MessageBox(
+    const HWND windowHandle,
+    const LPCSTR pText,
+    const LPCSTR pCaption,
+    const UINT type);
+
+__forceinline void PostQuitMessage(const INT exitCode);
+
+/*
+ * The "startPosixThread" function is the procedure of every POSIX thread.
+ * It calls the start address of the thread with its parameter.
+ */
+
+void* startPosixThread(void* pThread) {
+
+    const sPosixThread* const pPosixThread = pThread;
+    pPosixThread->pStartAddress(pPosixThread->pParameter);
+    return NULL;
+}
+
+/*
+ * The "CreateThread" function starts a thread running the passed procedure
+ * with the passed parameter. The attributes, stack size, creation flags
+ * and identifier of the thread are ignored. NULL is returned if the thread
+ * cannot be started.
+ */
+
+__forceinline HANDLE CreateThread(
+        __attribute__ ((unused)) void* const pAttributes,
+        __attribute__ ((unused)) const size_t stackSize,
+        const LPTHREAD_START_ROUTINE pStartAddress,
+        const LPVOID pParameter,
+        __attribute__ ((unused)) const DWORD creationFlags,
+        __attribute__ ((unused)) DWORD* const pThreadId) {
+
+    sPosixThread* const pThread = malloc(sizeof(sPosixThread));
+    if (pThread == NULL) {
+        return NULL;
+    }
+    pThread->isEvent = FALSE;
+    pThread->pStartAddress = pStartAddress;
+    pThread->pParameter = pParameter;
+    if (pthread_create(&pThread->thread, NULL, startPosixThread,
+            pThread) != 0) {
+        free(pThread);
+        return NULL;
+    }
+    return pThread;
+}
+
+/*
+ * The "CreateEvent" function creates an event in the passed state. Unless
+ * it is a manual-reset event, it is reset by the wait that it ends. The
+ * attributes and name of the event are ignored. NULL is returned if the
+ * event cannot be created.
+ */
+
+__forceinline HANDLE CreateEvent(
+        __attribute__ ((unused)) void* const pAttributes,
+        const BOOL isManualReset,
+        const BOOL isInitiallySignaled,
+        __attribute__ ((unused)) const LPCSTR pName) {
+
+    sPosixEvent* const pEvent = malloc(sizeof(sPosixEvent));
+    if (pEvent == NULL) {
+        return NULL;
+    }
+    pEvent->isEvent = TRUE;
+    pEvent->isManualReset = isManualReset;
+    pEvent->isSignaled = isInitiallySignaled;
+    if (pthread_mutex_init(&pEvent->mutex, NULL) != 0) {
+        free(pEvent);
+        return NULL;
+    }
+    if (pthread_cond_init(&pEvent->condition, NULL) != 0) {
+        pthread_mutex_destroy(&pEvent->mutex);
+        free(pEvent);
+        return NULL;
+    }
+    return pEvent;
+}
+
+/*
+ * The "SetEvent" function signals the passed event, waking the threads
+ * waiting for it.
+ */
+
+__forceinline BOOL SetEvent(const HANDLE handle) {
+
+    sPosixEvent* const pEvent = handle;
+    pthread_mutex_lock(&pEvent->mutex);
+    pEvent->isSignaled = TRUE;
+    pthread_cond_broadcast(&pEvent->condition);
+    pthread_mutex_unlock(&pEvent->mutex);
+    return TRUE;
+}
+
+/*
+ * The "WaitForMultipleObjects" function waits for every passed thread to
+ * return and for every passed event to be signaled, one after the other.
+ * Objects are always waited for without a time-out.
+ */
+
+__forceinline DWORD WaitForMultipleObjects(
+        const DWORD count,
+        const HANDLE* const pHandles,
+        __attribute__ ((unused)) const BOOL isWaitingAll,
+        __attribute__ ((unused)) const DWORD milliseconds) {
+
+    sPosixEvent* pEvent;
+    for (DWORD i = 0; i < count; i++) {
+        // The first member of both handles tells them apart.
+        if (!*(const BOOLEAN*) pHandles[i]) {
+            pthread_join(((sPosixThread*) pHandles[i])->thread, NULL);
+            continue;
+        }
+        pEvent = pHandles[i];
+        pthread_mutex_lock(&pEvent->mutex);
+        while (!pEvent->isSignaled) {
+            pthread_cond_wait(&pEvent->condition, &pEvent->mutex);
+        }
+        if (!pEvent->isManualReset) {
+            pEvent->isSignaled = FALSE;
+        }
+        pthread_mutex_unlock(&pEvent->mutex);
+    }
+    return 0;
+}
+
+/*
+ * The "WaitForSingleObject" function waits for the passed thread to
+ * return, or for the passed event to be signaled.
+ */
+
+__forceinline DWORD WaitForSingleObject(
+        const HANDLE handle,
+        const DWORD milliseconds) {
+    return WaitForMultipleObjects(1, &handle, TRUE, milliseconds);
+}
+
+/*
+ * The "CloseHandle" function releases the handle of a thread, which must
+ * have returned, or of an event, which no thread may wait for.
+ */
+
+__forceinline BOOL CloseHandle(const HANDLE handle) {
+
+    if (*(const BOOLEAN*) handle) {
+        pthread_cond_destroy(&((sPosixEvent*) handle)->condition);
+        pthread_mutex_destroy(&((sPosixEvent*) handle)->mutex);
+    }
+    free(handle);
+    return TRUE;
+}
+
+/*
+ * The "InterlockedIncrement" function atomically increments the passed
+ * value and returns the incremented value.
+ */
+
+__forceinline LONG InterlockedIncrement(volatile LONG* const pAddend) {
+    return __atomic_add_fetch(pAddend, 1, __ATOMIC_SEQ_CST);
+}
+
+/*
+ * The "QueryPerformanceFrequency" and "QueryPerformanceCounter" functions
+ * read a monotonic clock counting nanoseconds.
+ */
+
+__forceinline BOOL QueryPerformanceFrequency(
+        LARGE_INTEGER* const pFrequency) {
+    pFrequency->QuadPart = 1000000000;
+    return TRUE;
+}
+
+__forceinline BOOL QueryPerformanceCounter(LARGE_INTEGER* const pCount) {
+
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    pCount->QuadPart = (LONGLONG) time.tv_sec * 1000000000 + time.tv_nsec;
+    return TRUE;
+}
+
+/*
+ * The "GetSystemInfo" function only retrieves the number of logical
+ * processors online.
+ */
+
+__forceinline void GetSystemInfo(SYSTEM_INFO* const pSystemInfo) {
+
+    const long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    pSystemInfo->dwNumberOfProcessors = processors > 0 ? processors : 1;
+    return;
+}
+
+/*
+ * The "MessageBox" function prints its caption and text on the standard
+ * error stream, as no window displays them.
+ */
+
+__forceinline INT MessageBox(
+        __attribute__ ((unused)) const HWND windowHandle,
+        const LPCSTR pText,
+        const LPCSTR pCaption,
+        __attribute__ ((unused)) const UINT type) {
+    fprintf(stderr, "%s %s\n", pCaption, pText);
+    return 0;
+}
+
+/*
+ * The "PostQuitMessage" function requests the program running the game to
+ * quit.
+ */
+
+__forceinline void PostQuitMessage(
+        __attribute__ ((unused)) const INT exitCode) {
+    gIsQuitPosted = TRUE;
+    return;
+}
\ No newline at end of file
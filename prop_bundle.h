@@ -0,0 +1,24 @@
+#ifndef BLOCK_BUNDLE_MACROS
+
+// The asset bundle starts with a header, which is followed by an index of
+// entries. The header features the four magic characters below, a version
+// byte, a reserved byte, and the number of entries as a 16-bit integer.
+#define BUNDLE_MAGIC "FCDB"
+#define BUNDLE_VERSION 1
+#define BUNDLE_HEADER_BYTES 8
+
+// Every entry of the index features an asset type byte, an identifier
+// byte, two reserved bytes, and both the offset and the size of the asset
+// in the bundle as 32-bit integers. All integers are little-endian.
+#define BUNDLE_ENTRY_BYTES 12
+
+// The identifier of an entry distinguishes assets of the same type. It is
+// the mold identifier for molds and character graphics, and zero otherwise.
+#define ASSET_LEVEL 0
+#define ASSET_GEN 1
+#define ASSET_TILE 2
+#define ASSET_BACKGROUND 3
+#define ASSET_MOLD 4
+#define ASSET_CHARACTER_GRAPHIC 5
+
+#endif
\ No newline at end of file
@@ -1,9 +1,29 @@
 #ifndef BLOCK_DIR_MACROS
 
-#define DIR_FIRST_LEVEL "user\\Mukki\\levelinfo\\tutorial_1.lvl"
-#define DIR_FIRST_GEN "user\\Mukki\\levelinfo\\tutorial_1.txt"
-#define DIR_CHARACTER "user\\Abe\\chr\\"
-#define DIR_TILE "user\\Mukki\\tile\\tile.tmp"
-#define DIR_BACKGROUND "user\\Mukki\\bck.bci"
+// Directories are delimited by the separator native to the platform the
+// application is compiled for.
+#ifdef _WIN32
+#define DIR_SEPARATOR "\\"
+#else
+#define DIR_SEPARATOR "/"
+#endif
+
+#define DIR_FIRST_LEVEL "user" DIR_SEPARATOR "Mukki" DIR_SEPARATOR \
+    "levelinfo" DIR_SEPARATOR "tutorial_1.lvl"
+#define DIR_FIRST_GEN "user" DIR_SEPARATOR "Mukki" DIR_SEPARATOR \
+    "levelinfo" DIR_SEPARATOR "tutorial_1.txt"
+#define DIR_CHARACTER "user" DIR_SEPARATOR "Abe" DIR_SEPARATOR "chr" \
+    DIR_SEPARATOR
+#define DIR_TILE "user" DIR_SEPARATOR "Mukki" DIR_SEPARATOR "tile" \
+    DIR_SEPARATOR "tile.tmp"
+#define DIR_BACKGROUND "user" DIR_SEPARATOR "Mukki" DIR_SEPARATOR "bck.bci"
+#define DIR_BUNDLE "user" DIR_SEPARATOR "assets.fcb"
+#define DIR_CACHE "cache"
+#define DIR_CACHE_TILE DIR_CACHE DIR_SEPARATOR "tile.dcc"
+#define DIR_CACHE_BACKGROUND DIR_CACHE DIR_SEPARATOR "bck.dcc"
+#define DIR_BENCHMARK_LOG "benchmark.log"
+
+#define bitmapDirOf(character) DIR_CHARACTER #character ".bci"
+#define moldDirOf(character) DIR_CHARACTER #character ".mld"
 
 #endif
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef BLOCK_IMAGE_MACROS
+
+// The palette color below is rendered as a transparent pixel.
+#define PALETTE_TRANSPARENT 0xE3
+
+// Run-length coded images start with the marker byte below, which takes
+// the place of the color count of densely packed images. No packed image
+// features zero colors. The marker is followed by a version byte, the color
+// count, the palette, the size of the run stream as a little-endian 32-bit
+// integer, and the run stream itself.
+#define RUN_LENGTH_MARKER 0x00
+#define RUN_LENGTH_VERSION 1
+#define RUN_LENGTH_HEADER_BYTES 3
+#define RUN_LENGTH_STREAM_SIZE_BYTES 4
+
+// Every run of the run stream starts with a control byte. Its most
+// significant bits describe the type of the run, and its remaining bits
+// describe the run's pixel count minus one.
+// - A transparent run is not followed by any byte.
+// - A repeated run is followed by the color code that it repeats, in a byte.
+// - A literal run is followed by its color codes, packed like the ones of
+//   packed images, with the last byte padded with zeros.
+#define RUN_TYPE_MASK 0xC0
+#define RUN_TYPE_TRANSPARENT 0x00
+#define RUN_TYPE_REPEATED 0x40
+#define RUN_TYPE_LITERAL 0x80
+#define RUN_LITERAL_TYPE_MASK 0x80
+#define RUN_LITERAL_LENGTH_MASK 0x7F
+#define RUN_LENGTH_MASK 0x3F
+// Transparent and repeated runs whose length field holds the value below are
+// followed by a little-endian 16-bit integer, which is added to the value
+// below plus one to obtain the pixel count of the run.
+#define RUN_LENGTH_EXTENDED 0x3F
+
+#define RUN_MAX_LITERAL_PIXELS (RUN_LITERAL_LENGTH_MASK + 1)
+#define RUN_MAX_SHORT_PIXELS RUN_LENGTH_EXTENDED
+#define RUN_MAX_PIXELS (RUN_LENGTH_EXTENDED + 1 + 0xFFFF)
+
+#endif
@@ -1,74 +1,215 @@
 #pragma once
 
+#include "coordinator.h"
+#include "prop_image.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 /*
  * The set of function prototypes delimited by this block comment and the
  * one following it describe all function declarations regarding reading
  * image data.
  */
 
-__forceinline LRESULT fReadImage(
+// The struct below describes a file whose contents are mapped in the
+// address space of this process. Its contents can be read directly from
+// the mapping without copying them to other buffers. A view is a region of
+// another mapping, such as an asset of the bundle. Unmapping a view does not
+// release the mapping it is part of.
+typedef struct {
+    const BYTE* pData;
+    UINT32 size;
+    BOOLEAN isView;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+} sMappedFile;
+
+// The struct below describes an image read from a mapped file. Its palette
+// and encoded pixel data addresses point inside the mapping, which must
+// therefore remain mapped until the image is decoded. The encoded pixel data
+// of a run-length coded image is its run stream.
+typedef struct {
+    const BYTE* pPalette;
+    const BYTE* pEncodedPixelData;
+    UINT32 encodedPixelDataBytes;
+    UINT8 colors;
+    UINT8 colorCodeBits;
+    BOOLEAN isRunLength;
+} sEncodedImage;
+
+__forceinline LRESULT mapFile(
+    const CHAR* const restrict pDir,
+    sMappedFile* const restrict pMappedFile);
+
+__forceinline void unmapFile(sMappedFile* const restrict pMappedFile);
+
+__forceinline LRESULT readImage(
     const UINT32 encodedPixelDataPixels,
-    FILE* const restrict pFile,
-    UINT8* const restrict pCurColors,
-    UINT8* const restrict pColorCodeBits,
-    UINT32* const restrict pCurEncodedPixelDataBytes,
-    BYTE* restrict * const restrict ppPalette,
-    sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-    BYTE* restrict * const restrict ppEncodedPixelData);
+    const sMappedFile* const restrict pMappedFile,
+    UINT32* const restrict pOffset,
+    sEncodedImage* const restrict pImage);
 
 /*
- * The "fReadImage" function reads image data of a file passed as an 
- * argument. This image features color number, palette, and pixel
- * data information. This information is read and saved to dereferenced
- * arguments passed to the function call. The references passed and
- * potentially derefenced to reflect changes are as follows:
- * - Color number
- * - Number of bytes in encoded pixel data
- * - Address to the memory allocated for image palette data
- * - Address to the memory allocated for color code-to-pixel mapping
- *   derived from palette data
- * - Address to the memory allocated for encoded pixel data.
- * The function call requires the amount of pixels present in the pixel data.
- * This value must be passed as the first argument, preceding the file 
- * pointer argument.
+ * The "mapFile" function maps the entire contents of the file found at the
+ * passed directory for reading. The "unmapFile" function must be called
+ * once the contents are no longer read. An empty file is described by a
+ * null address and a size of zero. The function returns
+ * "ERROR_FILE_NOT_FOUND" if the file cannot be opened or mapped. It does
+ * not report this error itself since callers name the missing asset.
  */
 
-UINT8 maxColors = 0;
-UINT32 maxEncodedPixelDataBytes = 0;
+__forceinline LRESULT mapFile(
+        const CHAR* const restrict pDir,
+        sMappedFile* const restrict pMappedFile) {
 
-__forceinline LRESULT fReadImage(
-        const UINT32 encodedPixelDataPixels,
-        FILE* const restrict pFile,
-        UINT8* const restrict pCurColors,
-        UINT8* const restrict pColorCodeBits,
-        UINT32* const restrict pCurEncodedPixelDataBytes,
-        BYTE* restrict * const restrict ppPalette,
-        sPixel* restrict * const restrict ppColorCodeToPixelMapping,
-        BYTE* restrict * const restrict ppEncodedPixelData) {
-
-    UINT8 colors = fgetc(pFile);
-    if (colors > maxColors) {
-        maxColors = colors;
-        *pCurColors = colors;
-        free(*ppPalette);
-        // Every color in a palette header uses one byte.
-        *ppPalette = malloc(colors);
-        if (*ppPalette == NULL) {
-            panic("Memory allocation for raw character palette data \
-                failed.");
-            return ERROR_NOT_ENOUGH_MEMORY;
+    pMappedFile->pData = NULL;
+    pMappedFile->size = 0;
+    pMappedFile->isView = FALSE;
+#ifdef _WIN32
+    pMappedFile->mappingHandle = NULL;
+    pMappedFile->fileHandle = CreateFile(
+        pDir,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL);
+    if (pMappedFile->fileHandle == INVALID_HANDLE_VALUE) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(pMappedFile->fileHandle, &fileSize) == 0
+            || fileSize.QuadPart > (UINT32) -1) {
+        CloseHandle(pMappedFile->fileHandle);
+        return ERROR_FILE_NOT_FOUND;
+    }
+    // File mapping objects cannot be created for empty files.
+    if (fileSize.QuadPart == 0) {
+        return ERROR_SUCCESS;
+    }
+    pMappedFile->mappingHandle = CreateFileMapping(
+        pMappedFile->fileHandle,
+        NULL,
+        PAGE_READONLY,
+        0,
+        0,
+        NULL);
+    if (pMappedFile->mappingHandle == NULL) {
+        CloseHandle(pMappedFile->fileHandle);
+        return ERROR_FILE_NOT_FOUND;
+    }
+    pMappedFile->pData = MapViewOfFile(
+        pMappedFile->mappingHandle,
+        FILE_MAP_READ,
+        0,
+        0,
+        0);
+    if (pMappedFile->pData == NULL) {
+        CloseHandle(pMappedFile->mappingHandle);
+        CloseHandle(pMappedFile->fileHandle);
+        return ERROR_FILE_NOT_FOUND;
+    }
+    pMappedFile->size = (UINT32) fileSize.QuadPart;
+#else
+    const INT fileDescriptor = open(pDir, O_RDONLY);
+    if (fileDescriptor < 0) {
+        return ERROR_FILE_NOT_FOUND;
+    }
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0
+            || (UINT64) fileStatus.st_size > (UINT32) -1) {
+        close(fileDescriptor);
+        return ERROR_FILE_NOT_FOUND;
+    }
+    if (fileStatus.st_size > 0) {
+        const void* const pData = mmap(NULL, fileStatus.st_size, PROT_READ,
+            MAP_PRIVATE, fileDescriptor, 0);
+        if (pData == MAP_FAILED) {
+            close(fileDescriptor);
+            return ERROR_FILE_NOT_FOUND;
         }
-        free(*ppColorCodeToPixelMapping);
-        *ppColorCodeToPixelMapping = malloc(colors * sizeof(sPixel));
-        if (*ppColorCodeToPixelMapping == NULL) {
-            panic("Memory allocation of character palette pixel map \
-                failed.");
-            return ERROR_NOT_ENOUGH_MEMORY;
+        pMappedFile->pData = pData;
+        pMappedFile->size = (UINT32) fileStatus.st_size;
+    }
+    // The mapping remains valid once its file descriptor is closed.
+    close(fileDescriptor);
+#endif
+    return ERROR_SUCCESS;
+}
+
+__forceinline void unmapFile(sMappedFile* const restrict pMappedFile) {
+    if (pMappedFile->isView) {
+        pMappedFile->pData = NULL;
+        pMappedFile->size = 0;
+        return;
+    }
+#ifdef _WIN32
+    if (pMappedFile->pData != NULL) {
+        UnmapViewOfFile(pMappedFile->pData);
+        CloseHandle(pMappedFile->mappingHandle);
+    }
+    CloseHandle(pMappedFile->fileHandle);
+#else
+    if (pMappedFile->pData != NULL) {
+        munmap((void*) (UINT_PTR) pMappedFile->pData, pMappedFile->size);
+    }
+#endif
+    pMappedFile->pData = NULL;
+    pMappedFile->size = 0;
+    return;
+}
+
+/*
+ * The "readImage" function reads image data of a mapped file passed as an
+ * argument, starting at the dereferenced offset argument. This image
+ * features color number, palette, and pixel data information. This
+ * information is saved to the dereferenced image argument. Its palette and
+ * encoded pixel data are not copied, but refer to the mapping instead. The
+ * offset is advanced past the image such that images stored one after the
+ * other can be read in sequence. The function call requires the amount of
+ * pixels present in the pixel data. This value must be passed as the first
+ * argument, preceding the mapped file argument. Both densely packed and
+ * run-length coded images are read, the latter being recognized by their
+ * marker byte. The function returns "ERROR_INVALID_DATA" if the image
+ * extends beyond the end of the file or features an unknown version.
+ */
+
+__forceinline LRESULT readImage(
+        const UINT32 encodedPixelDataPixels,
+        const sMappedFile* const restrict pMappedFile,
+        UINT32* const restrict pOffset,
+        sEncodedImage* const restrict pImage) {
+
+    UINT32 offset = *pOffset;
+    if (offset >= pMappedFile->size) {
+        return ERROR_INVALID_DATA;
+    }
+    UINT8 colors = pMappedFile->pData[offset++];
+    pImage->isRunLength = colors == RUN_LENGTH_MARKER;
+    if (pImage->isRunLength) {
+        if (pMappedFile->size - offset < RUN_LENGTH_HEADER_BYTES - 1
+                || pMappedFile->pData[offset] != RUN_LENGTH_VERSION) {
+            return ERROR_INVALID_DATA;
         }
+        colors = pMappedFile->pData[offset + 1];
+        offset += RUN_LENGTH_HEADER_BYTES - 1;
     }
-    
-    fread(*ppPalette, colors, sizeof((*ppPalette)[0]), pFile);
-    
+    pImage->colors = colors;
+    // Every color in a palette header uses one byte.
+    if (pMappedFile->size - offset < colors) {
+        return ERROR_INVALID_DATA;
+    }
+    pImage->pPalette = pMappedFile->pData + offset;
+    offset += colors;
+
     // At this point, the "colors" variable becomes unused. Its modification
     // does not affect future behavior in the scope of this function.
     UINT8 colorCodeBits = 0;
@@ -76,27 +217,33 @@ __forceinline LRESULT fReadImage(
     do {
         colorCodeBits++;
     } while (colors >>= 1);
-    
-    *pColorCodeBits = colorCodeBits;
-    UINT32 encodedPixelDataBits = encodedPixelDataPixels * colorCodeBits;
-    UINT32 encodedPixelDataBytes = (encodedPixelDataBits + 7) / 8;
-    *pCurEncodedPixelDataBytes = encodedPixelDataBytes;
-    
-    if (encodedPixelDataBytes > maxEncodedPixelDataBytes) {
-        maxEncodedPixelDataBytes = encodedPixelDataBytes;
-        free(*ppEncodedPixelData);
-        *ppEncodedPixelData = malloc(encodedPixelDataBytes);
-        if (*ppEncodedPixelData == NULL) {
-            panic("Memory allocation of raw character graphics data \
-                failed.");
-            return ERROR_NOT_ENOUGH_MEMORY;
+
+    pImage->colorCodeBits = colorCodeBits;
+    if (pImage->isRunLength) {
+        if (pMappedFile->size - offset < RUN_LENGTH_STREAM_SIZE_BYTES) {
+            return ERROR_INVALID_DATA;
+        }
+        const BYTE* const pStreamSize = pMappedFile->pData + offset;
+        const UINT32 runStreamBytes = pStreamSize[0] | (pStreamSize[1] << 8)
+            | (pStreamSize[2] << 16) | ((UINT32) pStreamSize[3] << 24);
+        offset += RUN_LENGTH_STREAM_SIZE_BYTES;
+        if (pMappedFile->size - offset < runStreamBytes) {
+            return ERROR_INVALID_DATA;
         }
+        pImage->encodedPixelDataBytes = runStreamBytes;
+        pImage->pEncodedPixelData = pMappedFile->pData + offset;
+        *pOffset = offset + runStreamBytes;
+        return ERROR_SUCCESS;
     }
-    fread(
-        *ppEncodedPixelData,
-        encodedPixelDataBytes,
-        sizeof((*ppEncodedPixelData)[0]),
-        pFile);
-    
+    const UINT64 encodedPixelDataBits = (UINT64) encodedPixelDataPixels
+        * colorCodeBits;
+    const UINT64 encodedPixelDataBytes = (encodedPixelDataBits + 7) / 8;
+    if (pMappedFile->size - offset < encodedPixelDataBytes) {
+        return ERROR_INVALID_DATA;
+    }
+    pImage->encodedPixelDataBytes = (UINT32) encodedPixelDataBytes;
+    pImage->pEncodedPixelData = pMappedFile->pData + offset;
+    *pOffset = offset + (UINT32) encodedPixelDataBytes;
+
     return ERROR_SUCCESS;
 }
@@ -2,62 +2,80 @@
 
 #include "coordinator.h"
 #include "prop_render.h"
+#include "management_atlas.h"
+#include "render_span.h"
 
 /*
  * Functions defined in this file take care of rendering character sprites on
- * the window backbuffer. They are not responsible for checking bounds of what
- * they are rendering however. That is, arguments can cause pixels to render
- * outside the backbuffer's allocation memory.
+ * the window backbuffer. They only render within the clipping rectangle they
+ * are passed, and are not responsible for checking its bounds however. That
+ * is, arguments can cause pixels to render outside the backbuffer's
+ * allocation memory.
  */
 
 __forceinline void renderCharacter(
-        const sMold mold,
-        const INT8 animState,
-        const sPosition screenPos,
-        const UINT8 stopColumn,
-        const UINT8 leftShiftedColumns);
+    const UINT8 moldId,
+    const INT8 animState,
+    const sPosition screenPos,
+    const UINT8 stopColumn,
+    const UINT8 leftShiftedColumns,
+    const sRect clip);
 
 /*
  * The "renderCharacter" function renders a character sprite on the window
- * backbuffer. 
+ * backbuffer. The columns of the sprite from the left-shifted columns up to
+ * the stop column are rendered from the passed screen position, and only
+ * their pixels within the passed clipping rectangle of the screen are. The
+ * frame of the sprite is fetched from the atlas. Its opaque spans are
+ * rendered by the most capable kernel that the processor supports. Nothing
+ * is rendered if the atlas is not built.
  */
 
 __forceinline void renderCharacter(
-        const sMold mold,
+        const UINT8 moldId,
         const INT8 animState,
         const sPosition screenPos,
         const UINT8 stopColumn,
-        const UINT8 leftShiftedColumns) {
+        const UINT8 leftShiftedColumns,
+        const sRect clip) {
+    
+    const sMold* const restrict pMold = &gCharacterMolds[moldId];
+    sRect visible = {
+        screenPos.x,
+        screenPos.y,
+        screenPos.x + stopColumn - leftShiftedColumns,
+        screenPos.y + pMold->collision.height};
+    if (visible.left < clip.left) {
+        visible.left = clip.left;
+    }
+    if (visible.bottom < clip.bottom) {
+        visible.bottom = clip.bottom;
+    }
+    if (visible.right > clip.right) {
+        visible.right = clip.right;
+    }
+    if (visible.top > clip.top) {
+        visible.top = clip.top;
+    }
+    if (visible.left >= visible.right || visible.bottom >= visible.top) {
+        return;
+    }
     
-    const UINT8 characterWidth = mold.collision.width;
-    const UINT8 characterHeight = mold.collision.height;
     const BOOLEAN isMirrored = animState < 0;
     const INT8 framesToSubtract = isMirrored ? animState : ~animState;
-    sPixel* const restrict pReferencePixel = (sPixel*) gBackbuffer.pPixelData
-        + (screenPos.y * BACKBUFFER_WIDTH) + screenPos.x;
-    const sPixel* const restrict pFramePixelData = mold.pPixelData
-        + (characterWidth * characterHeight 
-        * (mold.frames + framesToSubtract));
-    const INT8 progressionStep = ((3 >> isMirrored) - 2);
-    const UINT8 mirroredFactor = characterWidth * isMirrored - isMirrored;
-    const UINT16 lastPixel = characterHeight * characterWidth;
-    sPixel pixelBuffer;
-    
-    for (UINT16 spritePixelRows = 0,
-            backbufferPixelRows = 0;
-            spritePixelRows < lastPixel;
-            spritePixelRows += characterWidth,
-            backbufferPixelRows += BACKBUFFER_WIDTH) {
-        for (UINT8 pixels = leftShiftedColumns;
-                pixels < stopColumn;
-                pixels++) {
-            pixelBuffer = pFramePixelData[spritePixelRows
-                + pixels * progressionStep + mirroredFactor];
-            if (pixelBuffer.whole != COLOR_TRANSPARENT) {
-                pReferencePixel[backbufferPixelRows + pixels
-                    - leftShiftedColumns] = pixelBuffer;
-            }
-        }
+    // Mirrored frames are packed with their own spans, such that their
+    // columns are read from left to right as well.
+    const sSpanImage* const restrict pFrame = fetchMoldFrame(moldId,
+        pMold->frames + framesToSubtract, isMirrored);
+    if (pFrame == NULL) {
+        return;
     }
+    sPixel* const restrict pReferencePixel = (sPixel*) gBackbuffer.pPixelData
+        + (visible.bottom * BACKBUFFER_WIDTH) + visible.left;
+    renderSpanImage(pReferencePixel, pFrame, (sRect) {
+        leftShiftedColumns + visible.left - screenPos.x,
+        visible.bottom - screenPos.y,
+        leftShiftedColumns + visible.right - screenPos.x,
+        visible.top - screenPos.y});
     return;
 }
\ No newline at end of file
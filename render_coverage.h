@@ -0,0 +1,155 @@
+#pragma once
+
+#include "coordinator.h"
+#include "render_indexed.h"
+
+/*
+ * The functions of this file track which pixels of a row of the backbuffer
+ * are covered by a coverage bitmap, featuring a bit per pixel. Scenes
+ * rendered front to back render their upper layers first, and only fill
+ * the pixels that these layers left uncovered with the lower ones. Runs of
+ * uncovered pixels are found a word of the bitmap at a time.
+ */
+
+#define COVERAGE_WORDS ((BACKBUFFER_WIDTH + 63) / 64)
+
+__forceinline void coverPixels(
+    UINT64* const restrict pCoverage,
+    const UINT16 start,
+    const UINT16 stop);
+
+__forceinline UINT16 findUncoveredRun(
+    const UINT64* const restrict pCoverage,
+    UINT16* const restrict pColumn,
+    const UINT16 stop);
+
+__forceinline UINT16 fillUncoveredPixels(
+    sPixel* const restrict pDestination,
+    const sPixel* const restrict pSource,
+    UINT64* const restrict pCoverage,
+    const UINT16 start,
+    const UINT16 stop);
+
+__forceinline UINT16 fillUncoveredIndexedPixels(
+    sPixel* const restrict pDestination,
+    const UINT8* const restrict pSource,
+    UINT64* const restrict pCoverage,
+    const UINT16 start,
+    const UINT16 stop);
+
+/*
+ * The "coverPixels" function sets the bits of the coverage bitmap of the
+ * pixels from the passed start column up to the passed stop column.
+ */
+
+__forceinline void coverPixels(
+        UINT64* const restrict pCoverage,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    UINT16 wordStop;
+    for (UINT16 column = start; column < stop; column = wordStop) {
+        wordStop = (column / 64 + 1) * 64;
+        if (wordStop > stop) {
+            wordStop = stop;
+        }
+        // A run as wide as a word cannot be shifted by its width.
+        pCoverage[column / 64] |= (wordStop - column == 64 ? ~0ULL
+            : (1ULL << (wordStop - column)) - 1) << (column % 64);
+    }
+    return;
+}
+
+/*
+ * The "findUncoveredRun" function advances the passed column to the next
+ * uncovered pixel before the passed stop column, and returns the column
+ * where its run of uncovered pixels stops. Runs stop at the next covered
+ * pixel, at the end of its word of the bitmap or at the stop column. When
+ * every remaining pixel is covered, the column is advanced to the stop
+ * column, which is then returned.
+ */
+
+__forceinline UINT16 findUncoveredRun(
+        const UINT64* const restrict pCoverage,
+        UINT16* const restrict pColumn,
+        const UINT16 stop) {
+
+    UINT16 column = *pColumn;
+    UINT16 runStop;
+    UINT64 bits;
+    while (column < stop) {
+        // Covered pixels are skipped up to the next uncovered one.
+        bits = ~pCoverage[column / 64] >> (column % 64);
+        if (bits == 0) {
+            column = (column / 64 + 1) * 64;
+            continue;
+        }
+        column += __builtin_ctzll(bits);
+        if (column >= stop) {
+            break;
+        }
+        bits = pCoverage[column / 64] >> (column % 64);
+        runStop = bits == 0 ? (column / 64 + 1) * 64
+            : column + __builtin_ctzll(bits);
+        *pColumn = column;
+        return runStop > stop ? stop : runStop;
+    }
+    *pColumn = stop;
+    return stop;
+}
+
+/*
+ * The "fillUncoveredPixels" function copies the source pixels of the
+ * passed columns which are not covered yet on the destination, and covers
+ * them. The first of these columns is copied from the passed source to the
+ * passed destination. The number of copied pixels is returned.
+ */
+
+__forceinline UINT16 fillUncoveredPixels(
+        sPixel* const restrict pDestination,
+        const sPixel* const restrict pSource,
+        UINT64* const restrict pCoverage,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    UINT16 filled = 0;
+    UINT16 column = start;
+    UINT16 runStop;
+    while ((runStop = findUncoveredRun(pCoverage, &column, stop))
+            > column) {
+        memcpy(pDestination + (column - start), pSource + (column - start),
+            (runStop - column) * sizeof(sPixel));
+        coverPixels(pCoverage, column, runStop);
+        filled += runStop - column;
+        column = runStop;
+    }
+    return filled;
+}
+
+/*
+ * The "fillUncoveredIndexedPixels" function expands the source 3-3-2
+ * colors of the passed columns which are not covered yet on the
+ * destination, and covers them. It is otherwise identical to the
+ * "fillUncoveredPixels" function.
+ */
+
+__forceinline UINT16 fillUncoveredIndexedPixels(
+        sPixel* const restrict pDestination,
+        const UINT8* const restrict pSource,
+        UINT64* const restrict pCoverage,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    UINT16 filled = 0;
+    UINT16 column = start;
+    UINT16 runStop;
+    while ((runStop = findUncoveredRun(pCoverage, &column, stop))
+            > column) {
+        expandIndexedPixels(pSource + (column - start), runStop - column,
+            pDestination + (column - start));
+        coverPixels(pCoverage, column, runStop);
+        filled += runStop - column;
+        column = runStop;
+    }
+    return filled;
+}
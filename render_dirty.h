@@ -0,0 +1,211 @@
+#pragma once
+
+#include "coordinator.h"
+
+/*
+ * The functions of this file track the regions of the backbuffer that
+ * change from one frame to the next. While the camera stands still, the
+ * background and tiles render identically every frame, such that only the
+ * rectangles that sprites leave or enter are rendered again. The rectangles
+ * of a frame are merged whenever they overlap, such that no pixel is
+ * rendered twice. Frames whose camera moves are rendered whole.
+ */
+
+// The macro below is the number of sprites that can be drawn in a frame,
+// which are the player and every character instance that an 8-bit index
+// can describe.
+#define MAX_SPRITE_DRAWS 256
+// The macro below is the number of rectangles that the dirty region of a
+// frame can feature. Frames featuring more rectangles are rendered whole.
+#define MAX_DIRTY_RECTS 16
+
+// The struct below describes how a sprite was drawn on the backbuffer. Its
+// rectangle is the area of the screen that its visible columns cover, which
+// are the columns of its frame from the left-shifted columns up to the stop
+// column.
+typedef struct {
+    sRect rect;
+    UINT8 moldId;
+    INT8 animState;
+    UINT8 leftShiftedColumns;
+    BOOLEAN isVisible;
+} sSpriteDraw;
+
+// The struct below describes the rectangles of the backbuffer to render
+// again. These rectangles do not overlap. A region that overflows covers
+// the whole backbuffer.
+typedef struct {
+    sRect rects[MAX_DIRTY_RECTS];
+    UINT8 rectNumber;
+    BOOLEAN isOverflowing;
+} sDirtyRegion;
+
+// The sprites drawn on the previous frame and the camera position it was
+// rendered at are compared against those of the current frame. No frame
+// was rendered before the first one, such that it is rendered whole.
+sSpriteDraw gPreviousSprites[MAX_SPRITE_DRAWS];
+UINT16 gPreviousCameraLeftPosX = 0;
+BOOLEAN gHasPreviousFrame = FALSE;
+// The debug overlay is written on the backbuffer and must not be left there
+// by frames that only render their dirty region. The backbuffer is saved
+// before the overlay is written, and restored before the next frame. The
+// overlay covers nearly every row of the backbuffer, which is saved whole.
+sPixel gOverlayBackup[BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT];
+BOOLEAN gIsOverlayDrawn = FALSE;
+// The number of pixels rendered again by the latest frame, which is shown
+// in the debug overlay.
+UINT32 gDirtyPixels = 0;
+
+__forceinline sRect clipSpriteRect(
+    const sPosition screenPos,
+    const UINT8 width,
+    const UINT8 height);
+
+__forceinline BOOLEAN doRectsOverlap(const sRect first, const sRect second);
+
+__forceinline sRect uniteRects(const sRect first, const sRect second);
+
+__forceinline void addDirtyRect(
+    sDirtyRegion* const restrict pRegion,
+    sRect rect);
+
+__forceinline void addSpriteChange(
+    sDirtyRegion* const restrict pRegion,
+    const sSpriteDraw* const restrict pPrevious,
+    const sSpriteDraw* const restrict pCurrent);
+
+__forceinline UINT32 countDirtyPixels(
+    const sDirtyRegion* const restrict pRegion);
+
+/*
+ * The "clipSpriteRect" function returns the rectangle of the screen that a
+ * sprite of the passed dimensions covers from the passed screen position.
+ * Its rows above the backbuffer are cut off. Sprites are not cut off
+ * horizontally, since their visible columns are found beforehand.
+ */
+
+__forceinline sRect clipSpriteRect(
+        const sPosition screenPos,
+        const UINT8 width,
+        const UINT8 height) {
+
+    const UINT16 top = screenPos.y + height;
+    return (sRect) {
+        screenPos.x,
+        screenPos.y,
+        screenPos.x + width,
+        top < BACKBUFFER_HEIGHT ? top : BACKBUFFER_HEIGHT};
+}
+
+/*
+ * The "doRectsOverlap" function returns whether two rectangles share at
+ * least one pixel.
+ */
+
+__forceinline BOOLEAN doRectsOverlap(const sRect first, const sRect second) {
+    return first.left < second.right && second.left < first.right
+        && first.bottom < second.top && second.bottom < first.top;
+}
+
+/*
+ * The "uniteRects" function returns the smallest rectangle that covers both
+ * passed rectangles.
+ */
+
+__forceinline sRect uniteRects(const sRect first, const sRect second) {
+    return (sRect) {
+        first.left < second.left ? first.left : second.left,
+        first.bottom < second.bottom ? first.bottom : second.bottom,
+        first.right > second.right ? first.right : second.right,
+        first.top > second.top ? first.top : second.top};
+}
+
+/*
+ * The "addDirtyRect" function adds a rectangle to a dirty region. Every
+ * rectangle of the region that it overlaps is removed and united with it,
+ * until it overlaps none of them. Empty rectangles are not added, and the
+ * region overflows if it cannot feature any more rectangle.
+ */
+
+__forceinline void addDirtyRect(
+        sDirtyRegion* const restrict pRegion,
+        sRect rect) {
+
+    if (pRegion->isOverflowing
+            || rect.left >= rect.right
+            || rect.bottom >= rect.top) {
+        return;
+    }
+    // The united rectangle may overlap rectangles tested before it, such
+    // that every rectangle is tested again after a union.
+    for (UINT8 i = 0; i < pRegion->rectNumber;) {
+        if (doRectsOverlap(rect, pRegion->rects[i])) {
+            rect = uniteRects(rect, pRegion->rects[i]);
+            pRegion->rects[i] = pRegion->rects[--pRegion->rectNumber];
+            i = 0;
+        } else {
+            i++;
+        }
+    }
+    if (pRegion->rectNumber == MAX_DIRTY_RECTS) {
+        pRegion->isOverflowing = TRUE;
+        return;
+    }
+    pRegion->rects[pRegion->rectNumber++] = rect;
+    return;
+}
+
+/*
+ * The "addSpriteChange" function adds to a dirty region the rectangles of a
+ * sprite whose drawing differs from the previous frame. Both the rectangle
+ * it leaves and the one it enters are added, united if they overlap.
+ */
+
+__forceinline void addSpriteChange(
+        sDirtyRegion* const restrict pRegion,
+        const sSpriteDraw* const restrict pPrevious,
+        const sSpriteDraw* const restrict pCurrent) {
+
+    if (!pPrevious->isVisible && !pCurrent->isVisible) {
+        return;
+    }
+    if (pPrevious->isVisible && pCurrent->isVisible
+            && pPrevious->moldId == pCurrent->moldId
+            && pPrevious->animState == pCurrent->animState
+            && pPrevious->leftShiftedColumns == pCurrent->leftShiftedColumns
+            && memcmp(&pPrevious->rect, &pCurrent->rect,
+                sizeof(pCurrent->rect)) == 0) {
+        return;
+    }
+    if (!pPrevious->isVisible) {
+        addDirtyRect(pRegion, pCurrent->rect);
+    } else if (!pCurrent->isVisible) {
+        addDirtyRect(pRegion, pPrevious->rect);
+    } else if (doRectsOverlap(pPrevious->rect, pCurrent->rect)) {
+        addDirtyRect(pRegion, uniteRects(pPrevious->rect, pCurrent->rect));
+    } else {
+        addDirtyRect(pRegion, pPrevious->rect);
+        addDirtyRect(pRegion, pCurrent->rect);
+    }
+    return;
+}
+
+/*
+ * The "countDirtyPixels" function returns the number of pixels that a dirty
+ * region covers. Its rectangles do not overlap, such that their areas are
+ * summed.
+ */
+
+__forceinline UINT32 countDirtyPixels(
+        const sDirtyRegion* const restrict pRegion) {
+
+    if (pRegion->isOverflowing) {
+        return BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT;
+    }
+    UINT32 pixels = 0;
+    for (UINT8 i = 0; i < pRegion->rectNumber; i++) {
+        pixels += (pRegion->rects[i].right - pRegion->rects[i].left)
+            * (pRegion->rects[i].top - pRegion->rects[i].bottom);
+    }
+    return pixels;
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "coordinator.h"
+#include "snapshot.h"
+#include "management_strip.h"
+#include "render_dirty.h"
+#include "render_scene.h"
+
+/*
+ * The function of this file renders the scene of a game state snapshot on
+ * the backbuffer. It performs every rendering step that does not depend on
+ * the platform, such that the window of the application and the headless
+ * renderer render frames identically. The debug overlay and the copy of the
+ * backbuffer to the screen are left to the caller.
+ */
+
+__forceinline void renderFrame(
+    const sSnapshot* const restrict pSnapshot,
+    const sPixel pBackground[const static BACKBUFFER_HEIGHT 
+    * BACKBUFFER_WIDTH]);
+
+/*
+ * The "renderFrame" function lists the sprites of the passed snapshot,
+ * compares them with those of the previous frame, and renders the passed
+ * background, the sprites and the tiles within every region of the
+ * backbuffer that changed. The whole backbuffer is rendered if the camera
+ * moved or if no frame was rendered before.
+ */
+
+__forceinline void renderFrame(
+        const sSnapshot* const restrict pSnapshot,
+        const sPixel pBackground[const static BACKBUFFER_HEIGHT 
+        * BACKBUFFER_WIDTH]) {
+    
+    /*
+     * The first subprocess concerns the player character's appearance on
+     * the viewport. The player character remains in the center of the
+     * screen when scrolling applies, which the camera of the snapshot
+     * describes.
+     */
+    
+    const sCamera* const pCamera = &pSnapshot->camera;
+    const sCharacter* const pPlayer = &pSnapshot->player;
+    
+    // The sprites of a frame are listed before any of them is rendered,
+    // such that they can be compared against those of the previous frame.
+    // The player is listed first, and each character instance at its index
+    // plus one. The player is always fully on-screen.
+    sSpriteDraw sprites[MAX_SPRITE_DRAWS];
+    sprites[0] = (sSpriteDraw) {
+        clipSpriteRect(pCamera->playerScreenPos,
+            gCharacterMolds[pPlayer->id].collision.width,
+            gCharacterMolds[pPlayer->id].collision.height),
+        player,
+        pPlayer->animState,
+        0,
+        TRUE};
+    
+    /*
+     * The second subprocess in this function lists all NPC graphics.
+     * Any NPC that is on the player's viewport becomes visible. NPC sprites
+     * are in function of the player character's screen and level position.
+     * NPCs outside of the viewport were culled by the logic of the game
+     * update that the snapshot was taken after.
+     */
+    
+    const UINT16 cameraLeftPosX = pCamera->leftPosX;
+    const UINT16 cameraRightPosX = cameraLeftPosX + BACKBUFFER_WIDTH;
+    
+    UINT16 characterLeftPosX;
+    UINT16 characterRightPosX;
+    UINT8 startCharacterPixelDataColumn;
+    UINT8 endCharacterPixelDataColumn;
+    
+    const sCharacter* pCharacter;
+    UINT8 characterId;
+    UINT8 characterWidth;
+    sSpriteDraw* pSprite;
+    
+    // Character instances are loaded once, such that their number is the
+    // same for every frame.
+    const UINT16 spriteNumber = 1 + pSnapshot->instances;
+    for (UINT8 instanceId = 0; 
+            instanceId < pSnapshot->instances; 
+            instanceId++) {
+        
+        pCharacter = &pSnapshot->characters[instanceId];
+        characterId = pCharacter->id;
+        pSprite = &sprites[instanceId + 1];
+        pSprite->isVisible = FALSE;
+        if (characterId == idNull) {
+            continue;
+        }
+        
+        characterLeftPosX = pCharacter->pos.x;
+        characterWidth = gCharacterMolds[characterId].collision.width;
+        characterRightPosX = characterLeftPosX + characterWidth;
+        if (characterRightPosX <= cameraLeftPosX
+                || characterLeftPosX >= cameraRightPosX) {
+            continue;
+        }
+            
+        // The first "if-else" statements here bounds the sprite's 
+        // right-most pixel column to render.
+        if (characterRightPosX > cameraRightPosX) {
+            startCharacterPixelDataColumn = cameraRightPosX 
+                - characterLeftPosX;
+        } else {
+            startCharacterPixelDataColumn = characterWidth;
+        }
+        // The second "if-else" statements here finds the sprite's first
+        // pixel column to render.
+        if (characterLeftPosX < cameraLeftPosX) {
+            endCharacterPixelDataColumn = cameraLeftPosX
+                - characterLeftPosX;
+            // Overlapping character and camera X positions renders
+            // at a screen X position of zero.
+            characterLeftPosX = cameraLeftPosX;
+        } else {
+            endCharacterPixelDataColumn = 0;
+        }
+        *pSprite = (sSpriteDraw) {
+            clipSpriteRect(
+                (sPosition) {
+                    characterLeftPosX - cameraLeftPosX,
+                    pCharacter->pos.y},
+                startCharacterPixelDataColumn
+                    - endCharacterPixelDataColumn,
+                gCharacterMolds[characterId].collision.height),
+            characterId,
+            pCharacter->animState,
+            endCharacterPixelDataColumn,
+            TRUE};
+    }
+    
+    /*
+     * The third subprocess finds the regions of the backbuffer to render.
+     * The background and tiles only move with the camera, such that frames
+     * whose camera moves are rendered whole. Other frames only render the
+     * rectangles of the sprites that differ from the previous frame.
+     */
+    
+    sDirtyRegion dirtyRegion = {
+        .rectNumber = 0,
+        .isOverflowing = !gHasPreviousFrame
+            || cameraLeftPosX != gPreviousCameraLeftPosX};
+    for (UINT16 i = 0; i < spriteNumber; i++) {
+        addSpriteChange(&dirtyRegion, &gPreviousSprites[i], &sprites[i]);
+    }
+    gDirtyPixels = countDirtyPixels(&dirtyRegion);
+    if (dirtyRegion.isOverflowing) {
+        dirtyRegion.rects[0] = (sRect) {
+            0, 0, BACKBUFFER_WIDTH, BACKBUFFER_HEIGHT};
+        dirtyRegion.rectNumber = 1;
+    }
+    memcpy(gPreviousSprites, sprites, spriteNumber * sizeof(sprites[0]));
+    gPreviousCameraLeftPosX = cameraLeftPosX;
+    gHasPreviousFrame = TRUE;
+    
+    /*
+     * The last subprocess renders the scene within every dirty rectangle.
+     * The background's pixel data renders first, for all other graphics to
+     * render on it. Sprites render next in the order they are listed, and
+     * all tiles in the viewport render last. Tiles are copied from the tile
+     * strip, whose runs skip rows and margins of transparent pixels.
+     * Columns that the camera newly exposes are composited in the strip
+     * beforehand.
+     */
+    
+    const UINT16 firstTileColumn = pCamera->firstTileColumn;
+    const UINT8 tileStartX = pCamera->tileStartX;
+    const UINT8 tileColumns = pCamera->tileColumns;
+    updateTileStrip(firstTileColumn, tileColumns);
+    
+    const sScene scene = {
+        pBackground,
+        sprites,
+        spriteNumber,
+        firstTileColumn,
+        tileStartX,
+        tileColumns};
+    gOverdraw = (sOverdraw) {0};
+    for (UINT8 i = 0; i < dirtyRegion.rectNumber; i++) {
+        renderScene(&scene, dirtyRegion.rects[i]);
+    }
+    return;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include "coordinator.h"
+#include "cpu.h"
+#include "decode.h"
+
+/*
+ * Functions defined in this file expand the indexed backbuffer on the
+ * window backbuffer. The indexed render mode composites the 3-3-2 colors
+ * of the background, sprites and tiles instead of their pixels, such that
+ * compositing moves a quarter of the bytes. Every 3-3-2 color is then
+ * expanded to its pixel once, by the table that palettes are decoded with.
+ * Vectorized kernels compute the entries of this table from the bits of
+ * several colors at once rather than reading it, since each channel of a
+ * pixel is a bit field of its color shifted in place. The kernel is
+ * selected as a function of the instruction set extensions that the
+ * processor supports.
+ */
+
+// The enumeration below lists the ways to expand 3-3-2 colors. They are
+// expanded by the most capable one that the processor supports, unless
+// another one is requested, for instance to compare them.
+enum {
+    expandScalar,
+    expandSsse3,
+    expandAvx2,
+    EXPANDER_VARIETY
+};
+
+// The array below is the indexed backbuffer, whose rows are laid out like
+// those of the window backbuffer.
+UINT8 gIndexedBackbuffer[BACKBUFFER_HEIGHT * BACKBUFFER_WIDTH];
+
+__forceinline UINT8 selectExpander();
+
+__forceinline void expandIndexedPixels(
+    const UINT8* const restrict pIndexedPixels,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+__forceinline void expandIndexedPixelsWith(
+    const UINT8 expander,
+    const UINT8* const restrict pIndexedPixels,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+__forceinline void expandIndexedRect(const sRect clip);
+
+__forceinline __m128i expandColorLanesSse2(const __m128i colors);
+
+__attribute__ ((target("avx2"))) __forceinline __m256i expandColorLanesAvx2(
+    const __m256i colors);
+
+__attribute__ ((target("ssse3"))) UINT32 expandIndexedPixelsSsse3(
+    const UINT8* const restrict pIndexedPixels,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+__attribute__ ((target("avx2"))) UINT32 expandIndexedPixelsAvx2(
+    const UINT8* const restrict pIndexedPixels,
+    const UINT32 pixels,
+    sPixel* const restrict pDestination);
+
+/*
+ * The "selectExpander" function returns the most capable way to expand
+ * 3-3-2 colors that the processor supports.
+ */
+
+__forceinline UINT8 selectExpander() {
+
+    switch(gSimdLevel) {
+        case simdAvx2:
+        return expandAvx2;
+
+        case simdSsse3:
+        return expandSsse3;
+
+        default:
+        return expandScalar;
+    }
+}
+
+/*
+ * The "expandIndexedPixels" function writes the pixel of every passed
+ * 3-3-2 color at the passed destination, by the most capable way that the
+ * processor supports.
+ */
+
+__forceinline void expandIndexedPixels(
+        const UINT8* const restrict pIndexedPixels,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+    expandIndexedPixelsWith(selectExpander(), pIndexedPixels, pixels,
+        pDestination);
+    return;
+}
+
+/*
+ * The "expandIndexedPixelsWith" function expands 3-3-2 colors by the
+ * passed way, which the processor must support. Colors that the vectorized
+ * kernels leave are expanded one by one through the table. It is otherwise
+ * identical to the "expandIndexedPixels" function.
+ */
+
+__forceinline void expandIndexedPixelsWith(
+        const UINT8 expander,
+        const UINT8* const restrict pIndexedPixels,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+
+    UINT32 i;
+    switch(expander) {
+        case expandAvx2:
+        i = expandIndexedPixelsAvx2(pIndexedPixels, pixels, pDestination);
+        break;
+
+        case expandSsse3:
+        i = expandIndexedPixelsSsse3(pIndexedPixels, pixels, pDestination);
+        break;
+
+        default:
+        i = 0;
+        break;
+    }
+    for (; i < pixels; i++) {
+        pDestination[i] = gColor332ToPixel[pIndexedPixels[i]];
+    }
+    return;
+}
+
+/*
+ * The "expandIndexedRect" function expands the passed clipping rectangle
+ * of the indexed backbuffer on the window backbuffer, row after row.
+ */
+
+__forceinline void expandIndexedRect(const sRect clip) {
+
+    const UINT8 expander = selectExpander();
+    const UINT8* pRow = gIndexedBackbuffer + clip.bottom * BACKBUFFER_WIDTH
+        + clip.left;
+    sPixel* pDestinationRow = (sPixel*) gBackbuffer.pPixelData
+        + clip.bottom * BACKBUFFER_WIDTH + clip.left;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        expandIndexedPixelsWith(expander, pRow, clip.right - clip.left,
+            pDestinationRow);
+        pRow += BACKBUFFER_WIDTH;
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return;
+}
+
+/*
+ * The "expandColorLanesSse2" and "expandColorLanesAvx2" functions expand
+ * the 3-3-2 color held by every 32-bit lane of the passed vector to its
+ * pixel. The red, green and blue bits of every color are masked and
+ * shifted to the top of their channels.
+ */
+
+__forceinline __m128i expandColorLanesSse2(const __m128i colors) {
+    return _mm_or_si128(
+        _mm_or_si128(
+            _mm_slli_epi32(_mm_and_si128(colors, _mm_set1_epi32(0xE0)), 16),
+            _mm_slli_epi32(_mm_and_si128(colors, _mm_set1_epi32(0x1C)), 11)),
+        _mm_slli_epi32(_mm_and_si128(colors, _mm_set1_epi32(0x03)), 6));
+}
+
+__attribute__ ((target("avx2"))) __forceinline __m256i expandColorLanesAvx2(
+        const __m256i colors) {
+    return _mm256_or_si256(
+        _mm256_or_si256(
+            _mm256_slli_epi32(
+                _mm256_and_si256(colors, _mm256_set1_epi32(0xE0)), 16),
+            _mm256_slli_epi32(
+                _mm256_and_si256(colors, _mm256_set1_epi32(0x1C)), 11)),
+        _mm256_slli_epi32(
+            _mm256_and_si256(colors, _mm256_set1_epi32(0x03)), 6));
+}
+
+/*
+ * The "expandIndexedPixelsSsse3" function expands sixteen 3-3-2 colors at
+ * a time. Each group of four colors is shuffled into the low bytes of four
+ * lanes, which are then expanded. The number of expanded colors is
+ * returned, which is a multiple of sixteen.
+ */
+
+__attribute__ ((target("ssse3"))) UINT32 expandIndexedPixelsSsse3(
+        const UINT8* const restrict pIndexedPixels,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+
+    const __m128i widenMasks[4] = {
+        _mm_setr_epi8(0, -1, -1, -1, 1, -1, -1, -1,
+            2, -1, -1, -1, 3, -1, -1, -1),
+        _mm_setr_epi8(4, -1, -1, -1, 5, -1, -1, -1,
+            6, -1, -1, -1, 7, -1, -1, -1),
+        _mm_setr_epi8(8, -1, -1, -1, 9, -1, -1, -1,
+            10, -1, -1, -1, 11, -1, -1, -1),
+        _mm_setr_epi8(12, -1, -1, -1, 13, -1, -1, -1,
+            14, -1, -1, -1, 15, -1, -1, -1)};
+    __m128i colors;
+    UINT32 i = 0;
+    for (; i + 16 <= pixels; i += 16) {
+        colors = _mm_loadu_si128((const __m128i*) (pIndexedPixels + i));
+        for (UINT8 j = 0; j < 4; j++) {
+            _mm_storeu_si128((__m128i*) (pDestination + i + j * 4),
+                expandColorLanesSse2(
+                    _mm_shuffle_epi8(colors, widenMasks[j])));
+        }
+    }
+    return i;
+}
+
+/*
+ * The "expandIndexedPixelsAvx2" function expands eight 3-3-2 colors at a
+ * time, like the "expandIndexedPixelsSsse3" function, zero-extending them
+ * to eight lanes at once. The number of expanded colors is returned, which
+ * is a multiple of eight.
+ */
+
+__attribute__ ((target("avx2"))) UINT32 expandIndexedPixelsAvx2(
+        const UINT8* const restrict pIndexedPixels,
+        const UINT32 pixels,
+        sPixel* const restrict pDestination) {
+
+    UINT32 i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        _mm256_storeu_si256((__m256i*) (pDestination + i),
+            expandColorLanesAvx2(_mm256_cvtepu8_epi32(
+                _mm_loadl_epi64((const __m128i*) (pIndexedPixels + i)))));
+    }
+    return i;
+}
\ No newline at end of file
@@ -0,0 +1,617 @@
+#pragma once
+
+#include "coordinator.h"
+#include "management_atlas.h"
+#include "render_character.h"
+#include "render_span.h"
+#include "render_strip.h"
+#include "render_dirty.h"
+#include "render_indexed.h"
+#include "management_background.h"
+#include "task.h"
+
+/*
+ * Functions defined in this file render the scene of a frame within a
+ * clipping rectangle of the backbuffer. The scene is layered as follows:
+ * the background first, then sprites in the order they are listed, and
+ * tiles last. It is rendered either layer after layer over the whole
+ * rectangle, or scanline after scanline. The latter composites every row
+ * of the rectangle in a row buffer that stays in the data cache, and then
+ * writes each pixel of the backbuffer a single time, from left to right.
+ * Scenes can also be rendered front to back, from tiles down to the
+ * background. A coverage bitmap then tracks the pixels of every row that
+ * upper layers render, such that lower layers only fill the others.
+ * Scenes rendered in the indexed mode are composited layer after layer in
+ * 3-3-2 colors on the indexed backbuffer, which is then expanded on the
+ * window backbuffer.
+ *
+ * Large rectangles are split in horizontal bands, which the workers of the
+ * task pool render concurrently. Bands share no pixel of the backbuffer,
+ * and the frames of sprites are fetched from the atlas before any band is
+ * rendered, such that workers only read shared memory.
+ */
+
+// The enumeration below lists the ways to render a scene. Ctrl + R cycles
+// through them while the application runs.
+enum {
+    renderLayered,
+    renderScanline,
+    renderFrontToBack,
+    renderIndexed,
+    RENDER_MODE_VARIETY
+};
+
+// Rectangles featuring fewer pixels than the value below are rendered by
+// the calling thread alone, since waking workers would take longer than
+// rendering them.
+#define BAND_MIN_PIXELS (BACKBUFFER_WIDTH * BACKBUFFER_HEIGHT / 4)
+
+// Rectangles overlapped by more sprites than the value below are rendered
+// layer after layer, fetching every frame as it is rendered. Frames fetched
+// beforehand must all remain in the frame slots of the atlas.
+#define SCENE_FRAMES ATLAS_FRAME_SLOTS
+
+// The struct below describes the scene of a frame. Its tiles are the
+// passed number of columns from the passed first one of the tile strip,
+// the left-most of which is cut off by "tileStartX" pixels.
+typedef struct {
+    const sPixel* pBackground;
+    const sSpriteDraw* pSprites;
+    UINT16 spriteNumber;
+    UINT16 firstTileColumn;
+    UINT8 tileStartX;
+    UINT8 tileColumns;
+} sScene;
+
+// The struct below describes the frames of the visible sprites of a scene
+// which overlap a rectangle, in the order they are listed, alongside their
+// indices in the list.
+typedef struct {
+    const sSpanImage* frames[SCENE_FRAMES];
+    UINT16 spriteIndices[SCENE_FRAMES];
+    UINT16 number;
+} sSceneFrames;
+
+// Scenes rendered front to back count the pixels of the rectangles they
+// render, the pixels that rendering them layer after layer would write, and
+// the pixels they write. The ratios of the latter two to the former are
+// the overdraw of either way, which the debug overlay shows.
+typedef struct {
+    UINT32 renderedPixels;
+    UINT32 layeredWrites;
+    UINT32 frontToBackWrites;
+} sOverdraw;
+
+// The struct below describes a band of a scene for a worker to render. Its
+// overdraw is summed with those of the other bands once they are rendered.
+typedef struct {
+    const sScene* pScene;
+    const sSceneFrames* pFrames;
+    sRect clip;
+    UINT8 mode;
+    sOverdraw overdraw;
+} sSceneBand;
+
+UINT8 gRenderMode = renderLayered;
+// Workers of the task pool are woken for every banded rectangle. Whether
+// bands render faster than the calling thread alone, once the wake-ups are
+// paid, depends on the processor, which the benchmark of banded rendering
+// measures. Banded rendering is thus off until Ctrl + B toggles it on.
+BOOLEAN gIsBanded = FALSE;
+sOverdraw gOverdraw = {0};
+
+__forceinline void renderScene(
+    const sScene* const restrict pScene,
+    const sRect clip);
+
+__forceinline void renderSceneBands(
+    const UINT8 mode,
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip,
+    const UINT8 bands,
+    sOverdraw* const restrict pOverdraw);
+
+LRESULT renderSceneBandTask(void* pArgument);
+
+__forceinline void renderSceneWith(
+    const UINT8 mode,
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip,
+    sOverdraw* const restrict pOverdraw);
+
+__forceinline void renderSceneLayered(
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip);
+
+__forceinline void renderSceneScanlines(
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip);
+
+__forceinline void renderSceneFrontToBack(
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip,
+    sOverdraw* const restrict pOverdraw);
+
+__forceinline void renderSceneIndexed(
+    const sScene* const restrict pScene,
+    const sSceneFrames* const restrict pFrames,
+    const sRect clip);
+
+__forceinline BOOLEAN fetchSceneFrames(
+    const sScene* const restrict pScene,
+    const sRect clip,
+    sSceneFrames* const restrict pFrames);
+
+__forceinline void renderSpriteFrame(
+    const sSpriteDraw* const restrict pSprite,
+    const sSpanImage* const restrict pFrame,
+    const sRect clip);
+
+__forceinline void fillSpriteRow(
+    sPixel* const restrict pDestinationRow,
+    const sSpriteDraw* const restrict pSprite,
+    const sSpanImage* const restrict pFrame,
+    const UINT16 row,
+    const sRect clip,
+    UINT64* const restrict pCoverage,
+    sOverdraw* const restrict pOverdraw);
+
+/*
+ * The "renderScene" function renders a scene within the passed clipping
+ * rectangle of the screen, in the current render mode. The frames of the
+ * sprites within the rectangle are fetched beforehand, unless more sprites
+ * are within the rectangle than the "SCENE_FRAMES" macro. Such scenes are
+ * rendered layer after layer by the calling thread, which fetches every
+ * frame as it renders it. Large rectangles are otherwise rendered in
+ * bands, if banding is enabled.
+ */
+
+__forceinline void renderScene(
+        const sScene* const restrict pScene,
+        const sRect clip) {
+
+    sSceneFrames frames;
+    if (!fetchSceneFrames(pScene, clip, &frames)) {
+        renderSceneLayered(pScene, NULL, clip);
+        return;
+    }
+    const UINT32 pixels = (clip.right - clip.left) * (clip.top - clip.bottom);
+    const UINT8 bands = gIsBanded && pixels >= BAND_MIN_PIXELS
+        ? gTaskPool.threads + 1 : 1;
+    renderSceneBands(gRenderMode, pScene, &frames, clip, bands, &gOverdraw);
+    return;
+}
+
+/*
+ * The "renderSceneBands" function splits the clipping rectangle in the
+ * passed number of horizontal bands of equal height, and renders a scene
+ * within every band concurrently on the task pool, in the passed render
+ * mode. The overdraw of every band is added to the passed one. A single
+ * band is rendered by the calling thread.
+ */
+
+__forceinline void renderSceneBands(
+        const UINT8 mode,
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip,
+        const UINT8 bands,
+        sOverdraw* const restrict pOverdraw) {
+
+    if (bands <= 1) {
+        renderSceneWith(mode, pScene, pFrames, clip, pOverdraw);
+        return;
+    }
+    sSceneBand sceneBands[TASK_MAX_WORKERS];
+    sTask tasks[TASK_MAX_WORKERS];
+    const UINT16 bandHeight = (clip.top - clip.bottom + bands - 1) / bands;
+    UINT8 taskNumber = 0;
+    for (UINT16 bottom = clip.bottom;
+            bottom < clip.top && taskNumber < TASK_MAX_WORKERS;
+            bottom += bandHeight) {
+        sceneBands[taskNumber] = (sSceneBand) {
+            pScene,
+            pFrames,
+            (sRect) {
+                clip.left,
+                bottom,
+                clip.right,
+                bottom + bandHeight < clip.top 
+                    ? bottom + bandHeight : clip.top},
+            mode,
+            {0}};
+        tasks[taskNumber] = (sTask) {renderSceneBandTask,
+            &sceneBands[taskNumber], "Band", NULL, ERROR_SUCCESS, 0};
+        taskNumber++;
+    }
+    runPooledTasks(tasks, taskNumber);
+    for (UINT8 i = 0; i < taskNumber; i++) {
+        pOverdraw->renderedPixels += sceneBands[i].overdraw.renderedPixels;
+        pOverdraw->layeredWrites += sceneBands[i].overdraw.layeredWrites;
+        pOverdraw->frontToBackWrites 
+            += sceneBands[i].overdraw.frontToBackWrites;
+    }
+    return;
+}
+
+/*
+ * The "renderSceneBandTask" function renders the band of a scene that its
+ * argument describes. It is run by a worker of the task pool, and never
+ * fails.
+ */
+
+LRESULT renderSceneBandTask(void* pArgument) {
+
+    sSceneBand* const pBand = pArgument;
+    renderSceneWith(pBand->mode, pBand->pScene, pBand->pFrames, pBand->clip,
+        &pBand->overdraw);
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "renderSceneWith" function renders a scene within the passed clipping
+ * rectangle in the passed render mode, from the passed frames of its
+ * sprites. Overdraw is added to the passed one.
+ */
+
+__forceinline void renderSceneWith(
+        const UINT8 mode,
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip,
+        sOverdraw* const restrict pOverdraw) {
+
+    switch(mode) {
+        case renderScanline:
+        renderSceneScanlines(pScene, pFrames, clip);
+        break;
+
+        case renderFrontToBack:
+        renderSceneFrontToBack(pScene, pFrames, clip, pOverdraw);
+        break;
+
+        case renderIndexed:
+        renderSceneIndexed(pScene, pFrames, clip);
+        break;
+
+        default:
+        renderSceneLayered(pScene, pFrames, clip);
+        break;
+    }
+    return;
+}
+
+/*
+ * The "renderSceneLayered" function renders every layer of a scene over
+ * the whole clipping rectangle, one after the other. The background's rows
+ * are copied first, for all other graphics to render on it. Sprites are
+ * rendered from the passed frames, or fetched one after the other from the
+ * atlas if no frames are passed.
+ */
+
+__forceinline void renderSceneLayered(
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip) {
+
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        memcpy(pBackbuffer + row * BACKBUFFER_WIDTH + clip.left,
+            pScene->pBackground + row * BACKBUFFER_WIDTH + clip.left,
+            (clip.right - clip.left) * sizeof(sPixel));
+    }
+    const sSpriteDraw* pSprite;
+    if (pFrames != NULL) {
+        for (UINT16 i = 0; i < pFrames->number; i++) {
+            renderSpriteFrame(&pScene->pSprites[pFrames->spriteIndices[i]],
+                pFrames->frames[i], clip);
+        }
+    } else {
+        for (UINT16 i = 0; i < pScene->spriteNumber; i++) {
+            pSprite = &pScene->pSprites[i];
+            if (pSprite->isVisible) {
+                renderCharacter(
+                    pSprite->moldId,
+                    pSprite->animState,
+                    (sPosition) {pSprite->rect.left, pSprite->rect.bottom},
+                    pSprite->leftShiftedColumns + pSprite->rect.right
+                        - pSprite->rect.left,
+                    pSprite->leftShiftedColumns,
+                    clip);
+            }
+        }
+    }
+    renderTileStrip(pScene->firstTileColumn, pScene->tileStartX,
+        pScene->tileColumns, clip);
+    return;
+}
+
+/*
+ * The "renderSceneScanlines" function renders a scene one row of the
+ * clipping rectangle at a time. Every layer of a row is composited in a row
+ * buffer, which is then copied on the backbuffer.
+ */
+
+__forceinline void renderSceneScanlines(
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip) {
+
+    const sSpriteDraw* pSprite;
+    sPixel rowBuffer[BACKBUFFER_WIDTH];
+    sPixel* pDestinationRow = (sPixel*) gBackbuffer.pPixelData 
+        + clip.bottom * BACKBUFFER_WIDTH;
+    UINT16 left, right;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        memcpy(rowBuffer + clip.left,
+            pScene->pBackground + row * BACKBUFFER_WIDTH + clip.left,
+            (clip.right - clip.left) * sizeof(sPixel));
+        for (UINT16 i = 0; i < pFrames->number; i++) {
+            pSprite = &pScene->pSprites[pFrames->spriteIndices[i]];
+            if (row < pSprite->rect.bottom || row >= pSprite->rect.top) {
+                continue;
+            }
+            left = pSprite->rect.left > clip.left 
+                ? pSprite->rect.left : clip.left;
+            right = pSprite->rect.right < clip.right 
+                ? pSprite->rect.right : clip.right;
+            renderOpaqueSpanRow(rowBuffer + left, pFrames->frames[i],
+                row - pSprite->rect.bottom,
+                pSprite->leftShiftedColumns + left - pSprite->rect.left,
+                pSprite->leftShiftedColumns + right - pSprite->rect.left);
+        }
+        if (row < STRIP_HEIGHT) {
+            renderTileStripRow(rowBuffer, row, pScene->firstTileColumn,
+                pScene->tileStartX, pScene->tileColumns, clip.left,
+                clip.right);
+        }
+        memcpy(pDestinationRow + clip.left, rowBuffer + clip.left,
+            (clip.right - clip.left) * sizeof(sPixel));
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return;
+}
+
+/*
+ * The "renderSceneFrontToBack" function renders a scene one row of the
+ * clipping rectangle at a time, from its upper layer down to its lower
+ * one. Tiles render first, then sprites in the reverse order they are
+ * listed, and the background last. Every layer only fills the pixels of
+ * the row that the layers above it left uncovered, such that every pixel
+ * is written once, as it would be layer after layer. Overdraw is added to
+ * the passed one.
+ */
+
+__forceinline void renderSceneFrontToBack(
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip,
+        sOverdraw* const restrict pOverdraw) {
+
+    const UINT16 width = clip.right - clip.left;
+    UINT64 coverage[COVERAGE_WORDS];
+    UINT16 tilePixels;
+    sPixel* pDestinationRow = (sPixel*) gBackbuffer.pPixelData 
+        + clip.bottom * BACKBUFFER_WIDTH;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        memset(coverage, 0x00, sizeof(coverage));
+        // Tiles are the upper layer, such that they cover no other pixel
+        // and are copied whole.
+        if (row < STRIP_HEIGHT) {
+            renderTileStripRow(pDestinationRow, row,
+                pScene->firstTileColumn, pScene->tileStartX,
+                pScene->tileColumns, clip.left, clip.right);
+            tilePixels = coverTileStripRow(coverage, row,
+                pScene->firstTileColumn, pScene->tileStartX,
+                pScene->tileColumns, clip.left, clip.right);
+            pOverdraw->layeredWrites += tilePixels;
+            pOverdraw->frontToBackWrites += tilePixels;
+        }
+        for (UINT16 i = pFrames->number; i-- > 0;) {
+            fillSpriteRow(pDestinationRow,
+                &pScene->pSprites[pFrames->spriteIndices[i]],
+                pFrames->frames[i], row, clip, coverage, pOverdraw);
+        }
+        pOverdraw->layeredWrites += width;
+        pOverdraw->frontToBackWrites += fillUncoveredPixels(
+            pDestinationRow + clip.left,
+            pScene->pBackground + row * BACKBUFFER_WIDTH + clip.left,
+            coverage, clip.left, clip.right);
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    pOverdraw->renderedPixels += width * (clip.top - clip.bottom);
+    return;
+}
+
+/*
+ * The "renderSceneIndexed" function renders a scene layer after layer like
+ * the "renderSceneLayered" function, but composites the 3-3-2 colors of
+ * its layers on the indexed backbuffer. The background is the one indexed
+ * when it was loaded. The clipping rectangle of the indexed backbuffer is
+ * then expanded on the window backbuffer in a single pass.
+ */
+
+__forceinline void renderSceneIndexed(
+        const sScene* const restrict pScene,
+        const sSceneFrames* const restrict pFrames,
+        const sRect clip) {
+
+    const UINT16 width = clip.right - clip.left;
+    UINT8* pDestinationRow = gIndexedBackbuffer 
+        + clip.bottom * BACKBUFFER_WIDTH;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        memcpy(pDestinationRow + clip.left,
+            gIndexedBackground + row * BACKBUFFER_WIDTH + clip.left, width);
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    const sSpriteDraw* pSprite;
+    sRect visible;
+    for (UINT16 i = 0; i < pFrames->number; i++) {
+        pSprite = &pScene->pSprites[pFrames->spriteIndices[i]];
+        visible = (sRect) {
+            pSprite->rect.left > clip.left ? pSprite->rect.left : clip.left,
+            pSprite->rect.bottom > clip.bottom ? pSprite->rect.bottom
+                : clip.bottom,
+            pSprite->rect.right < clip.right ? pSprite->rect.right
+                : clip.right,
+            pSprite->rect.top < clip.top ? pSprite->rect.top : clip.top};
+        if (visible.left >= visible.right) {
+            continue;
+        }
+        pDestinationRow = gIndexedBackbuffer 
+            + visible.bottom * BACKBUFFER_WIDTH + visible.left;
+        for (UINT16 row = visible.bottom; row < visible.top; row++) {
+            renderIndexedSpanRow(pDestinationRow, pFrames->frames[i],
+                row - pSprite->rect.bottom,
+                pSprite->leftShiftedColumns + visible.left 
+                    - pSprite->rect.left,
+                pSprite->leftShiftedColumns + visible.right 
+                    - pSprite->rect.left);
+            pDestinationRow += BACKBUFFER_WIDTH;
+        }
+    }
+    const UINT16 top = clip.top < STRIP_HEIGHT ? clip.top : STRIP_HEIGHT;
+    pDestinationRow = gIndexedBackbuffer + clip.bottom * BACKBUFFER_WIDTH;
+    for (UINT16 row = clip.bottom; row < top; row++) {
+        renderIndexedTileStripRow(pDestinationRow, row,
+            pScene->firstTileColumn, pScene->tileStartX,
+            pScene->tileColumns, clip.left, clip.right);
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    expandIndexedRect(clip);
+    return;
+}
+
+/*
+ * The "fetchSceneFrames" function fetches the frames of the visible sprites
+ * of a scene which overlap the clipping rectangle. Frames that cannot be
+ * fetched are skipped. FALSE is returned, and no frame is fetched, if more
+ * sprites overlap the rectangle than the "SCENE_FRAMES" macro.
+ */
+
+__forceinline BOOLEAN fetchSceneFrames(
+        const sScene* const restrict pScene,
+        const sRect clip,
+        sSceneFrames* const restrict pFrames) {
+
+    UINT16 overlappingSprites = 0;
+    const sSpriteDraw* pSprite;
+    pFrames->number = 0;
+    for (UINT16 i = 0; i < pScene->spriteNumber; i++) {
+        pSprite = &pScene->pSprites[i];
+        if (!pSprite->isVisible || !doRectsOverlap(pSprite->rect, clip)) {
+            continue;
+        }
+        if (overlappingSprites == SCENE_FRAMES) {
+            return FALSE;
+        }
+        pFrames->spriteIndices[overlappingSprites++] = i;
+    }
+    for (UINT16 i = 0; i < overlappingSprites; i++) {
+        pSprite = &pScene->pSprites[pFrames->spriteIndices[i]];
+        pFrames->frames[pFrames->number] = fetchMoldFrame(pSprite->moldId,
+            gCharacterMolds[pSprite->moldId].frames 
+                + (pSprite->animState < 0 
+                    ? pSprite->animState : ~pSprite->animState),
+            pSprite->animState < 0);
+        if (pFrames->frames[pFrames->number] != NULL) {
+            pFrames->spriteIndices[pFrames->number++] 
+                = pFrames->spriteIndices[i];
+        }
+    }
+    return TRUE;
+}
+
+/*
+ * The "renderSpriteFrame" function renders the frame of a sprite within
+ * the clipping rectangle, like the "renderCharacter" function, without
+ * fetching it.
+ */
+
+__forceinline void renderSpriteFrame(
+        const sSpriteDraw* const restrict pSprite,
+        const sSpanImage* const restrict pFrame,
+        const sRect clip) {
+
+    const sRect visible = {
+        pSprite->rect.left > clip.left ? pSprite->rect.left : clip.left,
+        pSprite->rect.bottom > clip.bottom ? pSprite->rect.bottom
+            : clip.bottom,
+        pSprite->rect.right < clip.right ? pSprite->rect.right : clip.right,
+        pSprite->rect.top < clip.top ? pSprite->rect.top : clip.top};
+    if (visible.left >= visible.right || visible.bottom >= visible.top) {
+        return;
+    }
+    renderSpanImage((sPixel*) gBackbuffer.pPixelData
+            + visible.bottom * BACKBUFFER_WIDTH + visible.left,
+        pFrame,
+        (sRect) {
+            pSprite->leftShiftedColumns + visible.left - pSprite->rect.left,
+            visible.bottom - pSprite->rect.bottom,
+            pSprite->leftShiftedColumns + visible.right - pSprite->rect.left,
+            visible.top - pSprite->rect.bottom});
+    return;
+}
+
+/*
+ * The "fillSpriteRow" function fills the pixels of a row of the screen
+ * that the opaque spans of a sprite render within the clipping rectangle,
+ * and which are not covered yet. The destination is the left-most pixel of
+ * the row of the screen. The filled pixels are counted in the passed
+ * overdraw.
+ */
+
+__forceinline void fillSpriteRow(
+        sPixel* const restrict pDestinationRow,
+        const sSpriteDraw* const restrict pSprite,
+        const sSpanImage* const restrict pFrame,
+        const UINT16 row,
+        const sRect clip,
+        UINT64* const restrict pCoverage,
+        sOverdraw* const restrict pOverdraw) {
+
+    if (row < pSprite->rect.bottom || row >= pSprite->rect.top) {
+        return;
+    }
+    const UINT16 left = pSprite->rect.left > clip.left 
+        ? pSprite->rect.left : clip.left;
+    const UINT16 right = pSprite->rect.right < clip.right 
+        ? pSprite->rect.right : clip.right;
+    // The screen column of a column of the frame is offset by the value
+    // below, which is negative for sprites cut off on the left.
+    const INT32 offset = (INT32) pSprite->rect.left
+        - pSprite->leftShiftedColumns;
+    const UINT16 frameRow = row - pSprite->rect.bottom;
+    const UINT8* const pRow = pFrame->pIndexedPixels
+        + frameRow * pFrame->width;
+    const sSpan* const pRowEnd = pFrame->pSpans 
+        + pFrame->pRowSpans[frameRow + 1];
+    INT32 start, stop;
+    for (const sSpan* pSpan = pFrame->pSpans + pFrame->pRowSpans[frameRow];
+            pSpan < pRowEnd;
+            pSpan++) {
+        start = pSpan->start + offset;
+        if (start >= right) {
+            break;
+        }
+        stop = start + pSpan->length;
+        if (stop > right) {
+            stop = right;
+        }
+        if (start < left) {
+            start = left;
+        }
+        if (start < stop) {
+            pOverdraw->layeredWrites += stop - start;
+            pOverdraw->frontToBackWrites += fillUncoveredIndexedPixels(
+                pDestinationRow + start, pRow + (start - offset), pCoverage,
+                start, stop);
+        }
+    }
+    return;
+}
\ No newline at end of file
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include "coordinator.h"
+#include "cpu.h"
+#include "prop_image.h"
+#include "management_span.h"
+#include "render_indexed.h"
+
+/*
+ * Functions defined in this file render images described by opaque spans on
+ * the window backbuffer. Like other rendering functions, they do not check
+ * the bounds of what they render. Images feature 3-3-2 colors, which are
+ * expanded to pixels as they are rendered. Opaque spans are either
+ * expanded one by one, or the colors from the first to the last span of
+ * each row are expanded and blended by vectorized kernels. These kernels
+ * compare several colors at once against the transparent palette color,
+ * and keep the destination pixels where the source is transparent. The
+ * kernel is selected as a function of the instruction set extensions that
+ * the processor supports.
+ */
+
+// The enumeration below lists the ways to render an image. Images are
+// rendered by the most capable one that the processor supports, unless
+// another one is requested, for instance to compare them.
+enum {
+    blitSpans,
+    blitMaskedSse2,
+    blitMaskedAvx2,
+    BLIT_VARIETY
+};
+
+__forceinline UINT8 selectBlitter();
+
+__forceinline void renderSpanImage(
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const sRect clip);
+
+__forceinline void renderSpanImageWith(
+    const UINT8 blitter,
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const sRect clip);
+
+__forceinline void renderMaskedRows(
+    void (*pRenderRow)(
+        sPixel* const restrict pDestination,
+        const UINT8* const restrict pSource,
+        const UINT32 pixels),
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const sRect clip);
+
+void renderMaskedRowSse2(
+    sPixel* const restrict pDestination,
+    const UINT8* const restrict pSource,
+    const UINT32 pixels);
+
+__attribute__ ((target("avx2"))) void renderMaskedRowAvx2(
+    sPixel* const restrict pDestination,
+    const UINT8* const restrict pSource,
+    const UINT32 pixels);
+
+__forceinline void renderOpaqueSpans(
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const sRect clip);
+
+__forceinline void renderOpaqueSpanRow(
+    sPixel* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const UINT16 row,
+    const UINT16 start,
+    const UINT16 stop);
+
+__forceinline void renderIndexedSpanRow(
+    UINT8* const restrict pDestination,
+    const sSpanImage* const restrict pImage,
+    const UINT16 row,
+    const UINT16 start,
+    const UINT16 stop);
+
+/*
+ * The "selectBlitter" function returns the most capable way to render
+ * images that the processor supports. Processors that do not support the
+ * SSSE3 extension are not assumed to support SSE2 either, and copy spans.
+ */
+
+__forceinline UINT8 selectBlitter() {
+
+    switch(gSimdLevel) {
+        case simdAvx2:
+        return blitMaskedAvx2;
+
+        case simdSsse3:
+        return blitMaskedSse2;
+
+        default:
+        return blitSpans;
+    }
+}
+
+/*
+ * The "renderSpanImage" function renders an image on the backbuffer by the
+ * most capable way that the processor supports. Only the pixels of the
+ * image within the passed clipping rectangle are rendered, in coordinates of
+ * the image. The bottom-left pixel of this rectangle is rendered at the
+ * passed destination, such that images cut off on the left or at the bottom
+ * render from the border of the backbuffer.
+ */
+
+__forceinline void renderSpanImage(
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const sRect clip) {
+    renderSpanImageWith(selectBlitter(), pDestination, pImage, clip);
+    return;
+}
+
+/*
+ * The "renderSpanImageWith" function renders an image on the backbuffer by
+ * the passed way, which the processor must support. It is otherwise
+ * identical to the "renderSpanImage" function.
+ */
+
+__forceinline void renderSpanImageWith(
+        const UINT8 blitter,
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const sRect clip) {
+
+    switch(blitter) {
+        case blitMaskedAvx2:
+        renderMaskedRows(renderMaskedRowAvx2, pDestination, pImage, clip);
+        break;
+
+        case blitMaskedSse2:
+        renderMaskedRows(renderMaskedRowSse2, pDestination, pImage, clip);
+        break;
+
+        default:
+        renderOpaqueSpans(pDestination, pImage, clip);
+        break;
+    }
+    return;
+}
+
+/*
+ * The "renderMaskedRows" function renders every row of an image by passing
+ * the pixels from the first to the last opaque span of the row to a
+ * vectorized kernel. Rows without any opaque span are skipped, as are the
+ * transparent pixels at either end of a row. The extent of a row is cut
+ * off by the clipping rectangle, whose rows are the only ones rendered.
+ */
+
+__forceinline void renderMaskedRows(
+        void (*pRenderRow)(
+            sPixel* const restrict pDestination,
+            const UINT8* const restrict pSource,
+            const UINT32 pixels),
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const sRect clip) {
+
+    const UINT8* pRow = pImage->pIndexedPixels
+        + clip.bottom * pImage->width;
+    sPixel* pDestinationRow = pDestination;
+    const sSpan* pLastSpan;
+    UINT16 start, stop;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        if (pImage->pRowSpans[row] != pImage->pRowSpans[row + 1]) {
+            start = pImage->pSpans[pImage->pRowSpans[row]].start;
+            pLastSpan = &pImage->pSpans[pImage->pRowSpans[row + 1] - 1];
+            stop = pLastSpan->start + pLastSpan->length;
+            if (stop > clip.right) {
+                stop = clip.right;
+            }
+            if (start < clip.left) {
+                start = clip.left;
+            }
+            if (start < stop) {
+                pRenderRow(pDestinationRow + (start - clip.left),
+                    pRow + start, stop - start);
+            }
+        }
+        pRow += pImage->width;
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return;
+}
+
+/*
+ * The "renderMaskedRowSse2" function blends eight pixels at a time of a row
+ * on the backbuffer. Eight colors are zero-extended to the lanes of two
+ * vectors and expanded. Colors matching the transparent palette color are
+ * masked out, such that the destination pixels are written back unchanged.
+ * Remaining colors are tested one by one.
+ */
+
+void renderMaskedRowSse2(
+        sPixel* const restrict pDestination,
+        const UINT8* const restrict pSource,
+        const UINT32 pixels) {
+
+    const __m128i transparent = _mm_set1_epi32(PALETTE_TRANSPARENT);
+    const __m128i zero = _mm_setzero_si128();
+    __m128i colors, halves[2], destination, isTransparent;
+    UINT32 i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        colors = _mm_unpacklo_epi8(
+            _mm_loadl_epi64((const __m128i*) (pSource + i)), zero);
+        halves[0] = _mm_unpacklo_epi16(colors, zero);
+        halves[1] = _mm_unpackhi_epi16(colors, zero);
+        for (UINT8 j = 0; j < 2; j++) {
+            destination = _mm_loadu_si128(
+                (const __m128i*) (pDestination + i + j * 4));
+            isTransparent = _mm_cmpeq_epi32(halves[j], transparent);
+            _mm_storeu_si128((__m128i*) (pDestination + i + j * 4),
+                _mm_or_si128(_mm_and_si128(isTransparent, destination),
+                    _mm_andnot_si128(isTransparent,
+                        expandColorLanesSse2(halves[j]))));
+        }
+    }
+    for (; i < pixels; i++) {
+        if (pSource[i] != PALETTE_TRANSPARENT) {
+            pDestination[i] = gColor332ToPixel[pSource[i]];
+        }
+    }
+    return;
+}
+
+/*
+ * The "renderMaskedRowAvx2" function blends eight pixels at a time of a row
+ * on the backbuffer, like the "renderMaskedRowSse2" function, but
+ * zero-extends and expands the eight colors in a single vector.
+ */
+
+__attribute__ ((target("avx2"))) void renderMaskedRowAvx2(
+        sPixel* const restrict pDestination,
+        const UINT8* const restrict pSource,
+        const UINT32 pixels) {
+
+    const __m256i transparent = _mm256_set1_epi32(PALETTE_TRANSPARENT);
+    __m256i colors, destination;
+    UINT32 i = 0;
+    for (; i + 8 <= pixels; i += 8) {
+        colors = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64((const __m128i*) (pSource + i)));
+        destination = _mm256_loadu_si256(
+            (const __m256i*) (pDestination + i));
+        _mm256_storeu_si256((__m256i*) (pDestination + i),
+            _mm256_blendv_epi8(expandColorLanesAvx2(colors), destination,
+            _mm256_cmpeq_epi32(colors, transparent)));
+    }
+    for (; i < pixels; i++) {
+        if (pSource[i] != PALETTE_TRANSPARENT) {
+            pDestination[i] = gColor332ToPixel[pSource[i]];
+        }
+    }
+    return;
+}
+
+/*
+ * The "renderOpaqueSpans" function expands the opaque spans of an image on
+ * the backbuffer, from its bottom row upwards. Spans are cut off by the
+ * clipping rectangle, whose rows are the only ones rendered.
+ */
+
+__forceinline void renderOpaqueSpans(
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const sRect clip) {
+
+    sPixel* pDestinationRow = pDestination;
+    for (UINT16 row = clip.bottom; row < clip.top; row++) {
+        renderOpaqueSpanRow(pDestinationRow, pImage, row, clip.left,
+            clip.right);
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return;
+}
+
+/*
+ * The "renderOpaqueSpanRow" function expands the opaque spans of a row of
+ * an image from the passed start column up to the passed stop column, by
+ * the most capable way that the processor supports. The first of these
+ * columns renders at the passed destination.
+ */
+
+__forceinline void renderOpaqueSpanRow(
+        sPixel* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const UINT16 row,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    const UINT8* const pRow = pImage->pIndexedPixels + row * pImage->width;
+    const UINT8 expander = selectExpander();
+    const sSpan* const pRowEnd = pImage->pSpans + pImage->pRowSpans[row + 1];
+    UINT16 spanStart, spanStop;
+    for (const sSpan* pSpan = pImage->pSpans + pImage->pRowSpans[row];
+            pSpan < pRowEnd;
+            pSpan++) {
+        spanStart = pSpan->start;
+        // Spans are sorted from left to right, such that no other span of
+        // the row is rendered past the first one cut off.
+        if (spanStart >= stop) {
+            break;
+        }
+        spanStop = spanStart + pSpan->length;
+        if (spanStop > stop) {
+            spanStop = stop;
+        }
+        if (spanStart < start) {
+            spanStart = start;
+        }
+        if (spanStart < spanStop) {
+            expandIndexedPixelsWith(expander, pRow + spanStart,
+                spanStop - spanStart, pDestination + (spanStart - start));
+        }
+    }
+    return;
+}
+
+/*
+ * The "renderIndexedSpanRow" function copies the 3-3-2 colors of the opaque
+ * spans of a row of an image, which the "renderOpaqueSpanRow" function
+ * expands instead.
+ */
+
+__forceinline void renderIndexedSpanRow(
+        UINT8* const restrict pDestination,
+        const sSpanImage* const restrict pImage,
+        const UINT16 row,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    const UINT8* const pRow = pImage->pIndexedPixels + row * pImage->width;
+    const sSpan* const pRowEnd = pImage->pSpans + pImage->pRowSpans[row + 1];
+    UINT16 spanStart, spanStop;
+    for (const sSpan* pSpan = pImage->pSpans + pImage->pRowSpans[row];
+            pSpan < pRowEnd;
+            pSpan++) {
+        spanStart = pSpan->start;
+        if (spanStart >= stop) {
+            break;
+        }
+        spanStop = spanStart + pSpan->length;
+        if (spanStop > stop) {
+            spanStop = stop;
+        }
+        if (spanStart < start) {
+            spanStart = start;
+        }
+        if (spanStart < spanStop) {
+            memcpy(pDestination + (spanStart - start), pRow + spanStart,
+                spanStop - spanStart);
+        }
+    }
+    return;
+}
\ No newline at end of file
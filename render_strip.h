@@ -0,0 +1,310 @@
+#pragma once
+
+#include "coordinator.h"
+#include "management_strip.h"
+#include "render_coverage.h"
+
+/*
+ * Functions defined in this file render the tiles of the level on the
+ * window backbuffer from the tile strip. Like other rendering functions,
+ * they only render within the clipping rectangle they are passed, and do
+ * not check its bounds.
+ */
+
+// The struct below describes a part of a row of the screen, whose pixels
+// are found from a column of the strip. The viewport of a row of the screen
+// features two such parts, where it wraps around the strip.
+typedef struct {
+    UINT16 screenStart;
+    UINT16 stripStart;
+    UINT16 stripStop;
+} sStripPart;
+
+__forceinline void renderTileStrip(
+    const UINT16 firstColumn,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const sRect clip);
+
+__forceinline void renderTileStripRow(
+    sPixel* const restrict pDestinationRow,
+    const UINT16 row,
+    const UINT16 firstColumn,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const UINT16 left,
+    const UINT16 right);
+
+__forceinline UINT8 findStripParts(
+    sStripPart parts[const static 2],
+    const UINT16 firstColumn,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const UINT16 left,
+    const UINT16 right);
+
+__forceinline UINT16 coverTileStripRow(
+    UINT64* const restrict pCoverage,
+    const UINT16 row,
+    const UINT16 firstColumn,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const UINT16 left,
+    const UINT16 right);
+
+__forceinline void renderStripRow(
+    sPixel* const restrict pDestination,
+    const UINT16 row,
+    const UINT16 start,
+    const UINT16 stop);
+
+__forceinline void renderIndexedTileStripRow(
+    UINT8* const restrict pDestinationRow,
+    const UINT16 row,
+    const UINT16 firstColumn,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const UINT16 left,
+    const UINT16 right);
+
+__forceinline void renderIndexedStripRow(
+    UINT8* const restrict pDestination,
+    const UINT16 row,
+    const UINT16 start,
+    const UINT16 stop);
+
+/*
+ * The "renderTileStrip" function renders the passed number of level
+ * columns from the passed first one, like the "renderTileColumns" function,
+ * but copies the runs of the strip instead of the spans of every tile.
+ * These columns must have been composited in the strip. The viewport
+ * starts in the strip at the slot of the first column, and continues from
+ * the first slot once it reaches the end of the strip.
+ */
+
+__forceinline void renderTileStrip(
+        const UINT16 firstColumn,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const sRect clip) {
+
+    const UINT16 top = clip.top < STRIP_HEIGHT ? clip.top : STRIP_HEIGHT;
+    sPixel* pDestinationRow = (sPixel*) gBackbuffer.pPixelData 
+        + clip.bottom * BACKBUFFER_WIDTH;
+    for (UINT16 row = clip.bottom; row < top; row++) {
+        renderTileStripRow(pDestinationRow, row, firstColumn, tileStartX,
+            columns, clip.left, clip.right);
+        pDestinationRow += BACKBUFFER_WIDTH;
+    }
+    return;
+}
+
+/*
+ * The "renderTileStripRow" function renders a row of the tiles of the
+ * viewport from the tile strip, from the passed left column of the screen
+ * up to the passed right one. The destination is the left-most pixel of
+ * the row of the screen. The row must be within the strip.
+ */
+
+__forceinline void renderTileStripRow(
+        sPixel* const restrict pDestinationRow,
+        const UINT16 row,
+        const UINT16 firstColumn,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const UINT16 left,
+        const UINT16 right) {
+
+    sStripPart parts[2];
+    const UINT8 partNumber = findStripParts(parts, firstColumn, tileStartX,
+        columns, left, right);
+    for (UINT8 i = 0; i < partNumber; i++) {
+        renderStripRow(pDestinationRow + parts[i].screenStart, row,
+            parts[i].stripStart, parts[i].stripStop);
+    }
+    return;
+}
+
+/*
+ * The "findStripParts" function finds the parts of a row of the screen
+ * from the passed left column up to the passed right one, which render the
+ * tiles of the viewport from the strip. The viewport starts in the strip
+ * at the slot of the first column, and is split in two where it wraps
+ * around the strip. The number of parts is returned, which is zero if the
+ * columns are not in the viewport.
+ */
+
+__forceinline UINT8 findStripParts(
+        sStripPart parts[const static 2],
+        const UINT16 firstColumn,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const UINT16 left,
+        const UINT16 right) {
+
+    // Slots past the passed columns may hold columns that are not in the
+    // viewport, and are cut off.
+    const UINT16 viewportStop = columns * TILE_SIZE - tileStartX;
+    const UINT16 stop = right < viewportStop ? right : viewportStop;
+    const UINT16 viewportStart = firstColumn % STRIP_COLUMNS * TILE_SIZE
+        + tileStartX;
+    const UINT16 wrap = STRIP_WIDTH - viewportStart;
+    const UINT16 firstStop = stop < wrap ? stop : wrap;
+    UINT8 partNumber = 0;
+    if (left < firstStop) {
+        parts[partNumber++] = (sStripPart) {
+            left,
+            viewportStart + left,
+            viewportStart + firstStop};
+    }
+    if (stop > wrap) {
+        const UINT16 secondLeft = left > wrap ? left : wrap;
+        parts[partNumber++] = (sStripPart) {
+            secondLeft,
+            secondLeft - wrap,
+            stop - wrap};
+    }
+    return partNumber;
+}
+
+/*
+ * The "coverTileStripRow" function covers the pixels of a row of the
+ * screen that the tiles of the viewport render, as the
+ * "renderTileStripRow" function finds them. The number of covered pixels
+ * is returned.
+ */
+
+__forceinline UINT16 coverTileStripRow(
+        UINT64* const restrict pCoverage,
+        const UINT16 row,
+        const UINT16 firstColumn,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const UINT16 left,
+        const UINT16 right) {
+
+    sStripPart parts[2];
+    const UINT8 partNumber = findStripParts(parts, firstColumn, tileStartX,
+        columns, left, right);
+    const sStripRun* const pRowEnd = gStripRuns + gStripRowRuns[row + 1];
+    UINT16 covered = 0;
+    UINT16 runStart, runStop;
+    for (UINT8 i = 0; i < partNumber; i++) {
+        for (const sStripRun* pRun = gStripRuns + gStripRowRuns[row];
+                pRun < pRowEnd && pRun->start < parts[i].stripStop;
+                pRun++) {
+            runStart = pRun->start > parts[i].stripStart
+                ? pRun->start : parts[i].stripStart;
+            runStop = pRun->start + pRun->length < parts[i].stripStop
+                ? pRun->start + pRun->length : parts[i].stripStop;
+            if (runStart < runStop) {
+                coverPixels(pCoverage,
+                    parts[i].screenStart + runStart - parts[i].stripStart,
+                    parts[i].screenStart + runStop - parts[i].stripStart);
+                covered += runStop - runStart;
+            }
+        }
+    }
+    return covered;
+}
+
+/*
+ * The "renderStripRow" function copies the runs of a row of the strip
+ * from the passed start column up to the passed stop column. The first of
+ * these columns renders at the passed destination.
+ */
+
+__forceinline void renderStripRow(
+        sPixel* const restrict pDestination,
+        const UINT16 row,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    const sPixel* const pRow = gStripPixels + row * STRIP_WIDTH;
+    const sStripRun* const pRowEnd = gStripRuns + gStripRowRuns[row + 1];
+    UINT16 runStart, runStop;
+    for (const sStripRun* pRun = gStripRuns + gStripRowRuns[row];
+            pRun < pRowEnd;
+            pRun++) {
+        runStart = pRun->start;
+        // Runs are sorted from left to right, such that no other run of
+        // the row is rendered past the first one cut off.
+        if (runStart >= stop) {
+            break;
+        }
+        runStop = runStart + pRun->length;
+        if (runStop > stop) {
+            runStop = stop;
+        }
+        if (runStart < start) {
+            runStart = start;
+        }
+        if (runStart < runStop) {
+            memcpy(pDestination + (runStart - start), pRow + runStart,
+                (runStop - runStart) * sizeof(sPixel));
+        }
+    }
+    return;
+}
+
+/*
+ * The "renderIndexedTileStripRow" function renders the 3-3-2 colors of a
+ * row of the tiles of the viewport, like the "renderTileStripRow" function
+ * does with their pixels.
+ */
+
+__forceinline void renderIndexedTileStripRow(
+        UINT8* const restrict pDestinationRow,
+        const UINT16 row,
+        const UINT16 firstColumn,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const UINT16 left,
+        const UINT16 right) {
+
+    sStripPart parts[2];
+    const UINT8 partNumber = findStripParts(parts, firstColumn, tileStartX,
+        columns, left, right);
+    for (UINT8 i = 0; i < partNumber; i++) {
+        renderIndexedStripRow(pDestinationRow + parts[i].screenStart, row,
+            parts[i].stripStart, parts[i].stripStop);
+    }
+    return;
+}
+
+/*
+ * The "renderIndexedStripRow" function copies the 3-3-2 colors of the runs
+ * of a row of the strip, like the "renderStripRow" function does with their
+ * pixels.
+ */
+
+__forceinline void renderIndexedStripRow(
+        UINT8* const restrict pDestination,
+        const UINT16 row,
+        const UINT16 start,
+        const UINT16 stop) {
+
+    const UINT8* const pRow = gIndexedStripPixels + row * STRIP_WIDTH;
+    const sStripRun* const pRowEnd = gStripRuns + gStripRowRuns[row + 1];
+    UINT16 runStart, runStop;
+    for (const sStripRun* pRun = gStripRuns + gStripRowRuns[row];
+            pRun < pRowEnd;
+            pRun++) {
+        runStart = pRun->start;
+        if (runStart >= stop) {
+            break;
+        }
+        runStop = runStart + pRun->length;
+        if (runStop > stop) {
+            runStop = stop;
+        }
+        if (runStart < start) {
+            runStart = start;
+        }
+        if (runStart < runStop) {
+            memcpy(pDestination + (runStart - start), pRow + runStart,
+                runStop - runStart);
+        }
+    }
+    return;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "coordinator.h"
+#include "managment_level.h"
+#include "management_tile.h"
+#include "management_atlas.h"
+#include "render_span.h"
+#include "render_indexed.h"
+
+/*
+ * Functions defined in this file render the tiles of the level on the
+ * window backbuffer. Like other rendering functions, they only render within
+ * the clipping rectangle they are passed, and do not check its bounds.
+ */
+
+__forceinline void renderTileColumns(
+    const UINT16 firstTileIndex,
+    const UINT8 tileStartX,
+    const UINT8 columns,
+    const sRect clip);
+
+/*
+ * The "renderTileColumns" function renders the passed number of tile
+ * columns of the tilemap, starting from the column of the passed tile
+ * index. The left-most column is cut off by as many pixels as the
+ * "tileStartX" argument, such that it renders from the backbuffer's left
+ * border, and every other column renders a tile width to the right of the
+ * previous one. Only the pixels within the clipping rectangle of the screen
+ * are rendered. Transparent tiles are skipped, and the rows of opaque tiles
+ * are copied whole.
+ */
+
+__forceinline void renderTileColumns(
+        const UINT16 firstTileIndex,
+        const UINT8 tileStartX,
+        const UINT8 columns,
+        const sRect clip) {
+
+    sPixel* const pBackbuffer = gBackbuffer.pPixelData;
+    const UINT16 tileIndexEnd = firstTileIndex + columns * COLUMN_SIZE;
+    // The variable below is the screen column of the left border of the
+    // current tile column, offset by the pixels cut off from the left-most
+    // column such that it is never negative.
+    UINT16 shiftedTileLeft = 0;
+    sRect visible;
+    UINT16 tileBottom;
+    UINT8 tileId;
+    for (UINT16 columnIndex = firstTileIndex;
+            columnIndex < tileIndexEnd;
+            columnIndex += COLUMN_SIZE, shiftedTileLeft += TILE_SIZE) {
+        visible.left = shiftedTileLeft > clip.left + tileStartX
+            ? shiftedTileLeft - tileStartX : clip.left;
+        visible.right = shiftedTileLeft + TILE_SIZE < clip.right + tileStartX
+            ? shiftedTileLeft + TILE_SIZE - tileStartX : clip.right;
+        if (visible.left >= visible.right) {
+            continue;
+        }
+        for (UINT8 row = 0; row < COLUMN_SIZE; row++) {
+            tileBottom = row * TILE_SIZE;
+            visible.bottom = tileBottom > clip.bottom
+                ? tileBottom : clip.bottom;
+            visible.top = tileBottom + TILE_SIZE < clip.top
+                ? tileBottom + TILE_SIZE : clip.top;
+            tileId = gLevel.pTilemap[columnIndex + row];
+            if (visible.bottom >= visible.top
+                    || gTileOpacities[tileId] == opacityTransparent) {
+                continue;
+            }
+            if (gTileOpacities[tileId] == opacityOpaque) {
+                for (UINT16 y = visible.bottom; y < visible.top; y++) {
+                    expandIndexedPixels(
+                        fetchTileImage(tileId)->pIndexedPixels
+                            + (y - tileBottom) * TILE_SIZE
+                            + visible.left + tileStartX - shiftedTileLeft,
+                        visible.right - visible.left,
+                        pBackbuffer + y * BACKBUFFER_WIDTH + visible.left);
+                }
+                continue;
+            }
+            renderSpanImage(
+                pBackbuffer + visible.bottom * BACKBUFFER_WIDTH
+                    + visible.left,
+                fetchTileImage(tileId),
+                (sRect) {
+                    visible.left + tileStartX - shiftedTileLeft,
+                    visible.bottom - tileBottom,
+                    visible.right + tileStartX - shiftedTileLeft,
+                    visible.top - tileBottom});
+        }
+    }
+    return;
+}
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <immintrin.h>
+
+#include "coordinator.h"
+#include "cpu.h"
+
+/*
+ * Functions defined in this file scale the backbuffer up on a buffer the
+ * size of the window, which the platform then presents as it is. Every
+ * pixel of the backbuffer becomes a square of as many pixels as the scale,
+ * which is the largest integer factor that the window fits, such that
+ * pixels stay sharp. The scaled backbuffer is centered on the window, whose
+ * borders are left black where the window is not a multiple of the
+ * backbuffer. Each row of the backbuffer is scaled by a vectorized kernel,
+ * which shuffles every vector of pixels into as many vectors as the scale,
+ * and the scaled row is then copied on the rows above it. Kernels are
+ * compiled for every scale from two to eight, whose shuffle masks stay in
+ * registers, and larger scales share a kernel. The kernel is selected as a
+ * function of the instruction set extensions that the processor supports.
+ */
+
+// The scale is at most the value below. Larger windows are letterboxed.
+#define UPSCALE_MAX_SCALE 16
+// Kernels are compiled for every scale up to the value below.
+#define UPSCALE_MAX_KERNEL_SCALE 8
+
+// The enumeration below lists the ways to scale the backbuffer up. It is
+// scaled by the most capable one that the processor supports, unless
+// another one is requested, for instance to compare them.
+enum {
+    upscaleScalar,
+    upscaleSsse3,
+    upscaleAvx2,
+    UPSCALER_VARIETY
+};
+
+// The struct below describes the window buffer that the backbuffer is
+// scaled on. Rows are as far apart as the stride, in pixels, from the
+// bottom-left pixel of the window upwards, such that the stride is
+// negative for buffers stored from the top row downwards. The scaled
+// backbuffer starts from the left column and bottom row of the window that
+// the struct describes.
+typedef struct {
+    sPixel* pWindow;
+    INT32 stride;
+    UINT16 width;
+    UINT16 height;
+    UINT16 left;
+    UINT16 bottom;
+    UINT8 scale;
+} sUpscaleTarget;
+
+__forceinline BOOLEAN placeUpscaleTarget(
+    sUpscaleTarget* const restrict pTarget,
+    sPixel* const restrict pWindow,
+    const INT32 stride,
+    const UINT16 width,
+    const UINT16 height);
+
+__forceinline void clearUpscaleTarget(
+    const sUpscaleTarget* const restrict pTarget);
+
+__forceinline UINT8 selectUpscaler();
+
+__forceinline void upscaleBackbuffer(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource);
+
+__forceinline void upscaleBackbufferWith(
+    const UINT8 upscaler,
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource);
+
+__forceinline void copyUpscaledRow(
+    sPixel* const restrict pRow,
+    const INT32 stride,
+    const UINT8 scale);
+
+void upscaleRowsScalar(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource);
+
+__attribute__ ((target("ssse3"))) void upscaleRowsSsse3(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource);
+
+__attribute__ ((target("ssse3"))) __forceinline void upscaleRowsSsse3By(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource,
+    const UINT8 scale);
+
+__attribute__ ((target("avx2"))) void upscaleRowsAvx2(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource);
+
+__attribute__ ((target("avx2"))) __forceinline void upscaleRowsAvx2By(
+    const sUpscaleTarget* const restrict pTarget,
+    const sPixel* const restrict pSource,
+    const UINT8 scale);
+
+/*
+ * The "placeUpscaleTarget" function describes in the passed target the
+ * window buffer of the passed dimensions, whose bottom-left pixel and
+ * stride are passed. The largest scale that the window fits is chosen, and
+ * the scaled backbuffer is centered. FALSE is returned if the window is
+ * smaller than the backbuffer.
+ */
+
+__forceinline BOOLEAN placeUpscaleTarget(
+        sUpscaleTarget* const restrict pTarget,
+        sPixel* const restrict pWindow,
+        const INT32 stride,
+        const UINT16 width,
+        const UINT16 height) {
+
+    const UINT16 widthScale = width / BACKBUFFER_WIDTH;
+    const UINT16 heightScale = height / BACKBUFFER_HEIGHT;
+    UINT16 scale = widthScale < heightScale ? widthScale : heightScale;
+    if (scale == 0) {
+        return FALSE;
+    }
+    if (scale > UPSCALE_MAX_SCALE) {
+        scale = UPSCALE_MAX_SCALE;
+    }
+    *pTarget = (sUpscaleTarget) {
+        pWindow,
+        stride,
+        width,
+        height,
+        (width - BACKBUFFER_WIDTH * scale) / 2,
+        (height - BACKBUFFER_HEIGHT * scale) / 2,
+        scale};
+    return TRUE;
+}
+
+/*
+ * The "clearUpscaleTarget" function fills the window buffer of the passed
+ * target in black, which the borders around the scaled backbuffer then
+ * remain.
+ */
+
+__forceinline void clearUpscaleTarget(
+        const sUpscaleTarget* const restrict pTarget) {
+
+    sPixel* pRow = pTarget->pWindow;
+    for (UINT16 row = 0; row < pTarget->height; row++) {
+        memset(pRow, 0x00, pTarget->width * sizeof(sPixel));
+        pRow += pTarget->stride;
+    }
+    return;
+}
+
+/*
+ * The "selectUpscaler" function returns the most capable way to scale the
+ * backbuffer up that the processor supports.
+ */
+
+__forceinline UINT8 selectUpscaler() {
+
+    switch(gSimdLevel) {
+        case simdAvx2:
+        return upscaleAvx2;
+
+        case simdSsse3:
+        return upscaleSsse3;
+
+        default:
+        return upscaleScalar;
+    }
+}
+
+/*
+ * The "upscaleBackbuffer" function scales the passed backbuffer up on the
+ * window buffer of the passed target, by the most capable way that the
+ * processor supports. The borders around the scaled backbuffer are left
+ * unchanged.
+ */
+
+__forceinline void upscaleBackbuffer(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource) {
+    upscaleBackbufferWith(selectUpscaler(), pTarget, pSource);
+    return;
+}
+
+/*
+ * The "upscaleBackbufferWith" function scales the backbuffer up by the
+ * passed way, which the processor must support. It is otherwise identical
+ * to the "upscaleBackbuffer" function.
+ */
+
+__forceinline void upscaleBackbufferWith(
+        const UINT8 upscaler,
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource) {
+
+    switch(upscaler) {
+        case upscaleAvx2:
+        upscaleRowsAvx2(pTarget, pSource);
+        break;
+
+        case upscaleSsse3:
+        upscaleRowsSsse3(pTarget, pSource);
+        break;
+
+        default:
+        upscaleRowsScalar(pTarget, pSource);
+        break;
+    }
+    return;
+}
+
+/*
+ * The "copyUpscaledRow" function copies the passed scaled row on as many
+ * rows above it as the passed scale minus one.
+ */
+
+__forceinline void copyUpscaledRow(
+        sPixel* const restrict pRow,
+        const INT32 stride,
+        const UINT8 scale) {
+
+    for (UINT8 i = 1; i < scale; i++) {
+        memcpy(pRow + i * stride, pRow,
+            BACKBUFFER_WIDTH * scale * sizeof(sPixel));
+    }
+    return;
+}
+
+/*
+ * The "upscaleRowsScalar" function scales every row of the backbuffer up
+ * by repeating each pixel as many times as the scale.
+ */
+
+void upscaleRowsScalar(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource) {
+
+    const UINT8 scale = pTarget->scale;
+    const sPixel* pSourceRow = pSource;
+    sPixel* pRow = pTarget->pWindow + pTarget->bottom * pTarget->stride
+        + pTarget->left;
+    sPixel* pPixel;
+    for (UINT16 row = 0; row < BACKBUFFER_HEIGHT; row++) {
+        pPixel = pRow;
+        for (UINT16 x = 0; x < BACKBUFFER_WIDTH; x++) {
+            for (UINT8 i = 0; i < scale; i++) {
+                *pPixel++ = pSourceRow[x];
+            }
+        }
+        copyUpscaledRow(pRow, pTarget->stride, scale);
+        pSourceRow += BACKBUFFER_WIDTH;
+        pRow += scale * pTarget->stride;
+    }
+    return;
+}
+
+/*
+ * The "upscaleRowsSsse3" function selects the kernel compiled for the
+ * scale of the passed target, which shuffles four pixels at a time.
+ */
+
+__attribute__ ((target("ssse3"))) void upscaleRowsSsse3(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource) {
+
+    switch(pTarget->scale) {
+        case 1: upscaleRowsSsse3By(pTarget, pSource, 1); break;
+        case 2: upscaleRowsSsse3By(pTarget, pSource, 2); break;
+        case 3: upscaleRowsSsse3By(pTarget, pSource, 3); break;
+        case 4: upscaleRowsSsse3By(pTarget, pSource, 4); break;
+        case 5: upscaleRowsSsse3By(pTarget, pSource, 5); break;
+        case 6: upscaleRowsSsse3By(pTarget, pSource, 6); break;
+        case 7: upscaleRowsSsse3By(pTarget, pSource, 7); break;
+        case 8: upscaleRowsSsse3By(pTarget, pSource, 8); break;
+        default: upscaleRowsSsse3By(pTarget, pSource, pTarget->scale); break;
+    }
+    return;
+}
+
+/*
+ * The "upscaleRowsSsse3By" function scales every row of the backbuffer up
+ * by the passed scale. Four pixels are loaded at a time and shuffled into
+ * as many vectors as the scale, the pixel of each lane being the one of
+ * the loaded pixels that the lane repeats. Remaining pixels of the row are
+ * repeated one by one.
+ */
+
+__attribute__ ((target("ssse3"))) __forceinline void upscaleRowsSsse3By(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource,
+        const UINT8 scale) {
+
+    __m128i masks[UPSCALE_MAX_SCALE];
+    BYTE mask[sizeof(__m128i)];
+    for (UINT8 k = 0; k < scale; k++) {
+        for (UINT8 j = 0; j < sizeof(__m128i); j++) {
+            mask[j] = (k * 4 + j / 4) / scale * 4 + j % 4;
+        }
+        masks[k] = _mm_loadu_si128((const __m128i*) mask);
+    }
+
+    const sPixel* pSourceRow = pSource;
+    sPixel* pRow = pTarget->pWindow + pTarget->bottom * pTarget->stride
+        + pTarget->left;
+    __m128i pixels;
+    UINT16 x;
+    for (UINT16 row = 0; row < BACKBUFFER_HEIGHT; row++) {
+        for (x = 0; x + 4 <= BACKBUFFER_WIDTH; x += 4) {
+            pixels = _mm_loadu_si128((const __m128i*) (pSourceRow + x));
+            for (UINT8 k = 0; k < scale; k++) {
+                _mm_storeu_si128((__m128i*) (pRow + x * scale + k * 4),
+                    _mm_shuffle_epi8(pixels, masks[k]));
+            }
+        }
+        for (; x < BACKBUFFER_WIDTH; x++) {
+            for (UINT8 i = 0; i < scale; i++) {
+                pRow[x * scale + i] = pSourceRow[x];
+            }
+        }
+        copyUpscaledRow(pRow, pTarget->stride, scale);
+        pSourceRow += BACKBUFFER_WIDTH;
+        pRow += scale * pTarget->stride;
+    }
+    return;
+}
+
+/*
+ * The "upscaleRowsAvx2" function selects the kernel compiled for the scale
+ * of the passed target, which shuffles eight pixels at a time.
+ */
+
+__attribute__ ((target("avx2"))) void upscaleRowsAvx2(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource) {
+
+    switch(pTarget->scale) {
+        case 1: upscaleRowsAvx2By(pTarget, pSource, 1); break;
+        case 2: upscaleRowsAvx2By(pTarget, pSource, 2); break;
+        case 3: upscaleRowsAvx2By(pTarget, pSource, 3); break;
+        case 4: upscaleRowsAvx2By(pTarget, pSource, 4); break;
+        case 5: upscaleRowsAvx2By(pTarget, pSource, 5); break;
+        case 6: upscaleRowsAvx2By(pTarget, pSource, 6); break;
+        case 7: upscaleRowsAvx2By(pTarget, pSource, 7); break;
+        case 8: upscaleRowsAvx2By(pTarget, pSource, 8); break;
+        default: upscaleRowsAvx2By(pTarget, pSource, pTarget->scale); break;
+    }
+    return;
+}
+
+/*
+ * The "upscaleRowsAvx2By" function scales every row of the backbuffer up
+ * by the passed scale, like the "upscaleRowsSsse3By" function, but eight
+ * pixels at a time. Pixels are permuted across the whole vector, whose
+ * lanes are indexed by pixel rather than by byte.
+ */
+
+__attribute__ ((target("avx2"))) __forceinline void upscaleRowsAvx2By(
+        const sUpscaleTarget* const restrict pTarget,
+        const sPixel* const restrict pSource,
+        const UINT8 scale) {
+
+    __m256i indices[UPSCALE_MAX_SCALE];
+    UINT32 index[sizeof(__m256i) / sizeof(UINT32)];
+    for (UINT8 k = 0; k < scale; k++) {
+        for (UINT8 j = 0; j < sizeof(__m256i) / sizeof(UINT32); j++) {
+            index[j] = (k * 8 + j) / scale;
+        }
+        indices[k] = _mm256_loadu_si256((const __m256i*) index);
+    }
+
+    const sPixel* pSourceRow = pSource;
+    sPixel* pRow = pTarget->pWindow + pTarget->bottom * pTarget->stride
+        + pTarget->left;
+    __m256i pixels;
+    UINT16 x;
+    for (UINT16 row = 0; row < BACKBUFFER_HEIGHT; row++) {
+        for (x = 0; x + 8 <= BACKBUFFER_WIDTH; x += 8) {
+            pixels = _mm256_loadu_si256((const __m256i*) (pSourceRow + x));
+            for (UINT8 k = 0; k < scale; k++) {
+                _mm256_storeu_si256((__m256i*) (pRow + x * scale + k * 8),
+                    _mm256_permutevar8x32_epi32(pixels, indices[k]));
+            }
+        }
+        for (; x < BACKBUFFER_WIDTH; x++) {
+            for (UINT8 i = 0; i < scale; i++) {
+                pRow[x * scale + i] = pSourceRow[x];
+            }
+        }
+        copyUpscaledRow(pRow, pTarget->stride, scale);
+        pSourceRow += BACKBUFFER_WIDTH;
+        pRow += scale * pTarget->stride;
+    }
+    return;
+}
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "coordinator.h"
+
+/*
+ * The functions of this file describe the game state that a frame renders.
+ * Rendering reads a snapshot of this state rather than the state itself,
+ * such that the logic of the next game update can write the state while
+ * the frame of the current one renders on another thread. The state and
+ * its snapshot are then two buffers, and the snapshot is taken again once
+ * both threads are done. The camera follows the player, and is placed when
+ * the snapshot is taken.
+ */
+
+// The macro below is the number of character instances that a snapshot
+// holds, which is every instance that an 8-bit index can describe.
+#define MAX_SNAPSHOT_CHARACTERS 255
+
+// The struct below describes the camera of a frame. The player renders at
+// its screen position, and the left-most column of the screen is the level
+// column "leftPosX". Tiles render from the passed first column of the level
+// to as many columns, the left-most of which is cut off by "tileStartX"
+// pixels.
+typedef struct {
+    sPosition playerScreenPos;
+    UINT16 leftPosX;
+    UINT16 firstTileColumn;
+    UINT8 tileStartX;
+    UINT8 tileColumns;
+} sCamera;
+
+// The struct below is an immutable copy of the game state that a frame
+// renders. Only its character instances up to "instances" are valid.
+typedef struct {
+    sCharacter player;
+    sCharacter characters[MAX_SNAPSHOT_CHARACTERS];
+    UINT8 instances;
+    sCamera camera;
+} sSnapshot;
+
+__forceinline sCamera placeCamera(const sCharacter* const restrict pPlayer);
+
+__forceinline void takeSnapshot(sSnapshot* const restrict pSnapshot);
+
+/*
+ * The "placeCamera" function returns the camera following the passed
+ * player. The player remains in the center of the screen when scrolling
+ * applies, and the camera stops at either end of the level.
+ */
+
+__forceinline sCamera placeCamera(const sCharacter* const restrict pPlayer) {
+
+    // The variables below are used to determine the tiles to render
+    // on the viewport. Tile indices from the tilemap are used.
+    UINT16 leftRenderBoundaryTileIndex;
+    UINT16 rightRenderBoundaryTileIndex;
+
+    sPosition screenPos = pPlayer->pos;
+    const UINT8 playerWidth = gCharacterMolds[pPlayer->id].collision.width;
+    BOOLEAN isScrolling = FALSE;
+
+    if (screenPos.x > (gLevel.width - (BACKBUFFER_WIDTH - playerWidth)
+                / 2) - TILE_SIZE) {
+        screenPos.x = (screenPos.x - gLevel.width + BACKBUFFER_WIDTH
+            - playerWidth) + TILE_SIZE;
+        leftRenderBoundaryTileIndex = (gLevel.width - BACKBUFFER_WIDTH)
+            / TILE_SIZE * COLUMN_SIZE;
+        rightRenderBoundaryTileIndex = gLevel.width
+            / TILE_SIZE * COLUMN_SIZE;
+    } else if (screenPos.x >= (BACKBUFFER_WIDTH - playerWidth) / 2) {
+        screenPos.x = (BACKBUFFER_WIDTH - playerWidth) / 2;
+        leftRenderBoundaryTileIndex = (pPlayer->pos.x - BACKBUFFER_WIDTH / 2
+            + playerWidth / 2) / TILE_SIZE * COLUMN_SIZE;
+        rightRenderBoundaryTileIndex = (pPlayer->pos.x + BACKBUFFER_WIDTH / 2
+            + playerWidth / 2 + (TILE_SIZE - 1)) / TILE_SIZE * COLUMN_SIZE;
+        isScrolling = TRUE;
+    } else {
+        leftRenderBoundaryTileIndex = 0;
+        rightRenderBoundaryTileIndex = BACKBUFFER_WIDTH
+            / TILE_SIZE * COLUMN_SIZE;
+    }
+
+    const UINT16 tileScreenNegatedOffsetX = isScrolling ?
+        - ((pPlayer->pos.x + playerWidth / 2) % playerWidth) : 0;
+    // The tiles of the left-most column are shifted by "tileStartX"
+    // columns. This shift ensures that they render starting from the
+    // backbuffer's left border.
+    return (sCamera) {
+        screenPos,
+        pPlayer->pos.x - screenPos.x,
+        leftRenderBoundaryTileIndex / COLUMN_SIZE,
+        -(INT8) tileScreenNegatedOffsetX,
+        (rightRenderBoundaryTileIndex - leftRenderBoundaryTileIndex)
+            / COLUMN_SIZE};
+}
+
+/*
+ * The "takeSnapshot" function copies the player and every character
+ * instance in the passed snapshot, and places its camera.
+ */
+
+__forceinline void takeSnapshot(sSnapshot* const restrict pSnapshot) {
+
+    pSnapshot->player = gPlayer;
+    pSnapshot->instances = gMutableCharacterArray.instances
+        < MAX_SNAPSHOT_CHARACTERS ? gMutableCharacterArray.instances
+        : MAX_SNAPSHOT_CHARACTERS;
+    memcpy(pSnapshot->characters, gMutableCharacterArray.pCharacter,
+        pSnapshot->instances * sizeof(sCharacter));
+    pSnapshot->camera = placeCamera(&gPlayer);
+    return;
+}
\ No newline at end of file
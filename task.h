@@ -0,0 +1,309 @@
+#pragma once
+
+#include "coordinator.h"
+
+/*
+ * The functions of this file run independent procedures, called tasks,
+ * concurrently on a small pool of worker threads. The thread calling
+ * "runTasks" works on the tasks as well, such that a pool of one worker
+ * runs every task on the calling thread, in order. Tasks must not share
+ * writable memory with one another. Tasks run every frame are handed to the
+ * task pool instead, whose workers are started once and wait for tasks in
+ * between, rather than being started for every run.
+ */
+
+// The number of workers is the number of logical processors, bounded by the
+// value below and by the number of tasks.
+#define TASK_MAX_WORKERS 8
+
+// The struct below describes a task. The procedure is called with the
+// argument of the task. Its result, the first message it panicked with, if
+// any, and its duration in microseconds are saved once it returns.
+typedef struct {
+    LRESULT (*pProcedure)(void* pArgument);
+    void* pArgument;
+    const CHAR* pName;
+    const CHAR* pPanicMessage;
+    LRESULT result;
+    UINT32 microseconds;
+} sTask;
+
+// The struct below is shared by all workers running the same tasks. Each
+// worker takes the next task that no other worker took.
+typedef struct {
+    sTask* pTasks;
+    UINT8 tasks;
+    volatile LONG nextTask;
+} sTaskQueue;
+
+// The struct below describes the task pool. Its workers wait for their
+// start event to be signaled, then run the tasks of the queue below, and
+// signal their done event. They return instead if the pool is stopping.
+typedef struct {
+    HANDLE threadHandles[TASK_MAX_WORKERS - 1];
+    HANDLE startEventHandles[TASK_MAX_WORKERS - 1];
+    HANDLE doneEventHandles[TASK_MAX_WORKERS - 1];
+    sTaskQueue* pQueue;
+    UINT8 threads;
+    BOOLEAN isStopping;
+} sTaskPool;
+
+sTaskPool gTaskPool = {0};
+
+__forceinline UINT64 queryMicroseconds();
+
+__forceinline UINT8 countTaskWorkers(const UINT8 tasks);
+
+__forceinline LRESULT runTasks(
+    sTask* const restrict pTasks,
+    const UINT8 tasks,
+    const UINT8 workers);
+
+__forceinline LRESULT reportTaskResults(
+    sTask* const restrict pTasks,
+    const UINT8 tasks);
+
+DWORD WINAPI runQueuedTasks(LPVOID pQueue);
+
+__forceinline void startTaskPool(const UINT8 workers);
+
+__forceinline LRESULT runPooledTasks(
+    sTask* const restrict pTasks,
+    const UINT8 tasks);
+
+__forceinline void stopTaskPool();
+
+DWORD WINAPI runPoolWorker(LPVOID pWorker);
+
+/*
+ * The "queryMicroseconds" function returns a monotonic timestamp in
+ * microseconds.
+ */
+
+__forceinline UINT64 queryMicroseconds() {
+
+    UINT64 ticks, frequency;
+    QueryPerformanceFrequency((LARGE_INTEGER*) &frequency);
+    QueryPerformanceCounter((LARGE_INTEGER*) &ticks);
+    return ticks / frequency * 1000000 + ticks % frequency * 1000000
+        / frequency;
+}
+
+/*
+ * The "countTaskWorkers" function returns the number of workers to run the
+ * passed number of tasks with.
+ */
+
+__forceinline UINT8 countTaskWorkers(const UINT8 tasks) {
+
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    UINT8 workers = TASK_MAX_WORKERS;
+    if (systemInfo.dwNumberOfProcessors < workers) {
+        workers = (UINT8) systemInfo.dwNumberOfProcessors;
+    }
+    if (tasks < workers) {
+        workers = tasks;
+    }
+    return workers > 0 ? workers : 1;
+}
+
+/*
+ * The "runTasks" function runs all passed tasks on the passed number of
+ * workers, and returns once every task returned. Errors are reported as if
+ * the tasks had run one after the other: the result of the first task that
+ * failed, in the order of the array, is returned, and its panic message is
+ * displayed. Messages of later tasks that failed are discarded. The function
+ * falls back to fewer workers if threads cannot be created.
+ */
+
+__forceinline LRESULT runTasks(
+        sTask* const restrict pTasks,
+        const UINT8 tasks,
+        const UINT8 workers) {
+
+    sTaskQueue queue = {pTasks, tasks, 0};
+    HANDLE threadHandles[TASK_MAX_WORKERS];
+    UINT8 threads = 0;
+    for (; threads + 1 < workers && threads < TASK_MAX_WORKERS; threads++) {
+        threadHandles[threads] = CreateThread(NULL, 0, runQueuedTasks,
+            &queue, 0, NULL);
+        if (threadHandles[threads] == NULL) {
+            break;
+        }
+    }
+    // The calling thread is a worker itself.
+    runQueuedTasks(&queue);
+    if (threads > 0) {
+        WaitForMultipleObjects(threads, threadHandles, TRUE, INFINITE);
+    }
+    for (UINT8 i = 0; i < threads; i++) {
+        CloseHandle(threadHandles[i]);
+    }
+    return reportTaskResults(pTasks, tasks);
+}
+
+/*
+ * The "reportTaskResults" function returns the result of the first passed
+ * task that failed, in the order of the array, and displays its panic
+ * message, as if the tasks had run one after the other.
+ */
+
+__forceinline LRESULT reportTaskResults(
+        sTask* const restrict pTasks,
+        const UINT8 tasks) {
+
+    for (UINT8 i = 0; i < tasks; i++) {
+        if (pTasks[i].result == ERROR_SUCCESS) {
+            continue;
+        }
+        if (pTasks[i].pPanicMessage != NULL) {
+            panic(pTasks[i].pPanicMessage);
+        }
+        return pTasks[i].result;
+    }
+    return ERROR_SUCCESS;
+}
+
+/*
+ * The "runQueuedTasks" function is the procedure of every worker. It runs
+ * tasks of the passed queue until none remain. Panic messages of its tasks
+ * are deferred to the "runTasks" function, since the message box of one
+ * task would otherwise block the others, and quitting only concerns the
+ * thread that posts the quit message.
+ */
+
+DWORD WINAPI runQueuedTasks(LPVOID pQueue) {
+
+    sTaskQueue* const pTaskQueue = pQueue;
+    // A task may itself run tasks on the thread running it. The deferred
+    // panic message of the outer task is restored once they return.
+    const CHAR** const pOuterPanicMessage = gpDeferredPanicMessage;
+    sTask* pTask;
+    UINT64 start;
+    for (LONG taskId = InterlockedIncrement(&pTaskQueue->nextTask) - 1;
+            taskId < pTaskQueue->tasks;
+            taskId = InterlockedIncrement(&pTaskQueue->nextTask) - 1) {
+        pTask = &pTaskQueue->pTasks[taskId];
+        pTask->pPanicMessage = NULL;
+        gpDeferredPanicMessage = &pTask->pPanicMessage;
+        start = queryMicroseconds();
+        pTask->result = pTask->pProcedure(pTask->pArgument);
+        pTask->microseconds = queryMicroseconds() - start;
+    }
+    gpDeferredPanicMessage = pOuterPanicMessage;
+    return 0;
+}
+
+
+/*
+ * The "startTaskPool" function starts the workers of the task pool, which
+ * wait for tasks until the pool is stopped. The thread running pooled
+ * tasks is a worker itself, such that one fewer thread than the passed
+ * number of workers is started. The pool falls back to fewer workers if
+ * threads or their events cannot be created.
+ */
+
+__forceinline void startTaskPool(const UINT8 workers) {
+
+    gTaskPool.isStopping = FALSE;
+    UINT8 threads = 0;
+    for (; threads + 1 < workers && threads < TASK_MAX_WORKERS - 1;
+            threads++) {
+        gTaskPool.startEventHandles[threads] = CreateEvent(NULL, FALSE,
+            FALSE, NULL);
+        gTaskPool.doneEventHandles[threads] = CreateEvent(NULL, FALSE,
+            FALSE, NULL);
+        if (gTaskPool.startEventHandles[threads] != NULL
+                && gTaskPool.doneEventHandles[threads] != NULL) {
+            // Workers are passed their index in the arrays of the pool.
+            gTaskPool.threadHandles[threads] = CreateThread(NULL, 0,
+                runPoolWorker, (LPVOID) (UINT_PTR) threads, 0, NULL);
+            if (gTaskPool.threadHandles[threads] != NULL) {
+                continue;
+            }
+        }
+        if (gTaskPool.startEventHandles[threads] != NULL) {
+            CloseHandle(gTaskPool.startEventHandles[threads]);
+        }
+        if (gTaskPool.doneEventHandles[threads] != NULL) {
+            CloseHandle(gTaskPool.doneEventHandles[threads]);
+        }
+        break;
+    }
+    gTaskPool.threads = threads;
+    return;
+}
+
+/*
+ * The "runPooledTasks" function runs all passed tasks on the calling thread
+ * and on as many workers of the task pool as needed, and returns once every
+ * task returned. Errors are reported like the "runTasks" function does.
+ * Tasks run on the calling thread alone if the pool is not started.
+ */
+
+__forceinline LRESULT runPooledTasks(
+        sTask* const restrict pTasks,
+        const UINT8 tasks) {
+
+    sTaskQueue queue = {pTasks, tasks, 0};
+    const UINT8 threads = tasks - 1 < gTaskPool.threads
+        ? tasks - 1 : gTaskPool.threads;
+    gTaskPool.pQueue = &queue;
+    for (UINT8 i = 0; i < threads; i++) {
+        SetEvent(gTaskPool.startEventHandles[i]);
+    }
+    // The calling thread is a worker itself.
+    runQueuedTasks(&queue);
+    if (threads > 0) {
+        WaitForMultipleObjects(threads, gTaskPool.doneEventHandles, TRUE,
+            INFINITE);
+    }
+    gTaskPool.pQueue = NULL;
+    return reportTaskResults(pTasks, tasks);
+}
+
+/*
+ * The "stopTaskPool" function joins the workers of the task pool and
+ * releases their events. It is only called while no task runs.
+ */
+
+__forceinline void stopTaskPool() {
+
+    gTaskPool.isStopping = TRUE;
+    for (UINT8 i = 0; i < gTaskPool.threads; i++) {
+        SetEvent(gTaskPool.startEventHandles[i]);
+    }
+    if (gTaskPool.threads > 0) {
+        WaitForMultipleObjects(gTaskPool.threads, gTaskPool.threadHandles,
+            TRUE, INFINITE);
+    }
+    for (UINT8 i = 0; i < gTaskPool.threads; i++) {
+        CloseHandle(gTaskPool.threadHandles[i]);
+        CloseHandle(gTaskPool.startEventHandles[i]);
+        CloseHandle(gTaskPool.doneEventHandles[i]);
+    }
+    gTaskPool = (sTaskPool) {0};
+    return;
+}
+
+/*
+ * The "runPoolWorker" function is the procedure of every worker of the
+ * task pool, which is passed its index. It runs the tasks of the queue of
+ * the pool every time that its start event is signaled, until the pool is
+ * stopping.
+ */
+
+DWORD WINAPI runPoolWorker(LPVOID pWorker) {
+
+    const UINT_PTR worker = (UINT_PTR) pWorker;
+    for (;;) {
+        WaitForSingleObject(gTaskPool.startEventHandles[worker], INFINITE);
+        if (gTaskPool.isStopping) {
+            break;
+        }
+        runQueuedTasks(gTaskPool.pQueue);
+        SetEvent(gTaskPool.doneEventHandles[worker]);
+    }
+    return 0;
+}
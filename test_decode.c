@@ -0,0 +1,226 @@
+// This code is designed to be compiled with GCC.
+// The decode test compares the pixel data decoder against the byte-wise
+// decoder it replaced, which is kept below as the reference. It is executed
+// without arguments, and decodes random color codes of every length from
+// one to eight bits, over pixel counts that are not multiples of any group
+// of codes the kernels decode at once. Every image is decoded at every
+// level of instruction set extensions that the processor supports, and by
+// every number of workers. The first mismatching pixel of every failing
+// case is printed, and the exit status is nonzero if any case fails.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#define _POSIX_C_SOURCE 200809L
+#include "posix.h"
+#endif
+#include <stdio.h>
+
+#include "coordinator.h"
+#include "cpu.h"
+#include "decode.h"
+#include "task.h"
+
+// Pixels past the decoded ones are set to the value below beforehand, such
+// that writes past the pixel count are detected.
+#define TEST_GUARD_PIXEL 0xA5A5A5A5
+// Pixel counts of the images decoded by the test. The last one is large
+// enough for images to be split in chunks between workers.
+#define TEST_PIXEL_COUNTS {1, 3, 7, 9, 15, 17, 31, 33, 63, 65, 127, 129, \
+    255, 257, 1023, 1025, 4099, 8 * DECODE_MIN_PIXELS_PER_WORKER + 37}
+
+/*
+ * This section establishes and outlines function symbols used thoughout
+ * this program.
+ */
+
+__forceinline void decodePixelDataReference(
+    const UINT8 colors,
+    const UINT8 colorCodeBits,
+    const UINT32 encodedPixelDataBytes,
+    const BYTE* const restrict pPaletteDataBuffer,
+    sPixel* const restrict pCodeToPixelBuffer,
+    const BYTE* const restrict pPixelDataBuffer,
+    sPixel* const restrict pDestination);
+
+__forceinline void packColorCodes(
+    const UINT8 colorCodeBits,
+    const UINT8* const restrict pCodes,
+    const UINT32 pixels,
+    BYTE* const restrict pPixelData);
+
+/*
+ * The function below is the entry point to the decode test. Color codes
+ * are packed from the most significant bit of every byte, like the ".bci"
+ * format stores them, and every code indexes a color of the palette.
+ */
+
+int main() {
+
+    initSimdLevel();
+    const UINT8 supportedSimdLevel = gSimdLevel;
+    const UINT32 pixelCounts[] = TEST_PIXEL_COUNTS;
+    const UINT8 pixelCountNumber = sizeof(pixelCounts)
+        / sizeof(pixelCounts[0]);
+    const UINT32 maxPixels = pixelCounts[pixelCountNumber - 1];
+    UINT8* const pCodes = malloc(maxPixels);
+    BYTE* const pPixelData = malloc(maxPixels);
+    // The reference decodes every code that the last byte holds, which may
+    // be more than the pixel count.
+    sPixel* const pExpected = malloc((maxPixels + 8) * sizeof(sPixel));
+    sPixel* const pDecoded = malloc((maxPixels + 1) * sizeof(sPixel));
+    if (pCodes == NULL || pPixelData == NULL || pExpected == NULL
+            || pDecoded == NULL) {
+        fprintf(stderr, "Memory allocation failed.\n");
+        return EXIT_FAILURE;
+    }
+
+    BYTE palette[255];
+    sPixel codeToPixel[256];
+    srand(1);
+    for (UINT16 i = 0; i < sizeof(palette); i++) {
+        palette[i] = rand();
+    }
+    UINT32 cases = 0;
+    UINT32 failures = 0;
+    UINT8 colors;
+    UINT32 pixels, bytes, mismatch;
+    for (UINT8 colorCodeBits = 1; colorCodeBits <= 8; colorCodeBits++) {
+        // Palettes feature at most 255 colors, which eight-bit codes index.
+        colors = colorCodeBits == 8 ? 255 : 1 << colorCodeBits;
+        for (UINT8 count = 0; count < pixelCountNumber; count++) {
+            pixels = pixelCounts[count];
+            bytes = (pixels * colorCodeBits + 7) / 8;
+            for (UINT32 i = 0; i < pixels; i++) {
+                pCodes[i] = rand() % colors;
+            }
+            packColorCodes(colorCodeBits, pCodes, pixels, pPixelData);
+            decodePixelDataReference(colors, colorCodeBits, bytes, palette,
+                codeToPixel, pPixelData, pExpected);
+            for (UINT8 simdLevel = simdNone;
+                    simdLevel <= supportedSimdLevel;
+                    simdLevel++) {
+                gSimdLevel = simdLevel;
+                for (UINT8 workers = 1; workers <= TASK_MAX_WORKERS;
+                        workers++) {
+                    for (UINT32 i = 0; i <= pixels; i++) {
+                        pDecoded[i].whole = TEST_GUARD_PIXEL;
+                    }
+                    decodePixelDataConcurrently(workers, colors,
+                        colorCodeBits, pixels, bytes, palette, pPixelData,
+                        pDecoded);
+                    cases++;
+                    for (mismatch = 0; mismatch < pixels; mismatch++) {
+                        if (pDecoded[mismatch].whole
+                                != pExpected[mismatch].whole) {
+                            break;
+                        }
+                    }
+                    if (mismatch == pixels
+                            && pDecoded[pixels].whole == TEST_GUARD_PIXEL) {
+                        continue;
+                    }
+                    failures++;
+                    printf("%u-bit codes, %u pixels, SIMD level %u, "
+                        "%u workers: pixel %u differs\n", colorCodeBits,
+                        pixels, simdLevel, workers, mismatch);
+                }
+            }
+        }
+    }
+    gSimdLevel = supportedSimdLevel;
+    printf("%u of %u cases passed.\n", cases - failures, cases);
+    free(pCodes);
+    free(pPixelData);
+    free(pExpected);
+    free(pDecoded);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/*
+ * The "decodePixelDataReference" function is the byte-wise decoder which
+ * the "decodePixelDataFeaturing" function replaced. It decodes every color
+ * code that the encoded bytes hold, one byte after the other, and expands
+ * the palette into the passed color code-to-pixel mapping itself.
+ */
+
+__forceinline void decodePixelDataReference(
+        const UINT8 colors,
+        const UINT8 colorCodeBits,
+        const UINT32 encodedPixelDataBytes,
+        const BYTE* const restrict pPaletteDataBuffer,
+        sPixel* const restrict pCodeToPixelBuffer,
+        const BYTE* const restrict pPixelDataBuffer,
+        sPixel* const restrict pDestination) {
+
+    UINT8 extracted8bitPixel;
+    for (UINT8 i = 0; i < colors; i++) {
+        pCodeToPixelBuffer[i].alpha = 0;
+        extracted8bitPixel = pPaletteDataBuffer[i];
+        pCodeToPixelBuffer[i].blue = (extracted8bitPixel & 0x03) << 6;
+        extracted8bitPixel >>= 2;
+        pCodeToPixelBuffer[i].green = (extracted8bitPixel & 0x07) << 5;
+        extracted8bitPixel >>= 3;
+        pCodeToPixelBuffer[i].red = extracted8bitPixel << 5;
+    }
+
+    union {
+        struct {
+            BYTE low;
+            BYTE high;
+        };
+        UINT16 whole;
+    } parsedBits = {0};
+    UINT8 bitsToRead = sizeof(pPixelDataBuffer[0]) * 8;
+    UINT8 colorCodeBitmask = (1 << colorCodeBits) - 1;
+    UINT8 bitOffset = colorCodeBits;
+    UINT8 bitsToReadForNextIter;
+    UINT8 bitmaskForIter;
+    UINT32 pixelsWritten = 0;
+    for (UINT32 readBytes = 0;
+            readBytes < encodedPixelDataBytes;
+            readBytes++) {
+        parsedBits.low = pPixelDataBuffer[readBytes];
+        for (; bitOffset <= bitsToRead; bitOffset += colorCodeBits) {
+            pDestination[pixelsWritten] = pCodeToPixelBuffer[
+                (parsedBits.whole >> (bitsToRead - bitOffset))
+                & colorCodeBitmask];
+            pixelsWritten++;
+        }
+        bitsToReadForNextIter = bitsToRead % colorCodeBits;
+        parsedBits.high = 0;
+        bitsToRead = 8 + bitsToReadForNextIter;
+        for (bitmaskForIter = 0; bitsToReadForNextIter > 0;
+                bitsToReadForNextIter--) {
+            bitmaskForIter <<= 1;
+            bitmaskForIter |= 1;
+        }
+        parsedBits.high = parsedBits.low & bitmaskForIter;
+        bitOffset = colorCodeBits;
+    }
+    return;
+}
+
+/*
+ * The "packColorCodes" function packs the passed color codes one after the
+ * other from the most significant bit of the first byte. Bits of the last
+ * byte that no code uses are zero.
+ */
+
+__forceinline void packColorCodes(
+        const UINT8 colorCodeBits,
+        const UINT8* const restrict pCodes,
+        const UINT32 pixels,
+        BYTE* const restrict pPixelData) {
+
+    memset(pPixelData, 0, (pixels * colorCodeBits + 7) / 8);
+    UINT32 bit = 0;
+    for (UINT32 i = 0; i < pixels; i++) {
+        for (INT8 codeBit = colorCodeBits - 1; codeBit >= 0; codeBit--) {
+            pPixelData[bit / 8] |= (pCodes[i] >> codeBit & 1)
+                << (7 - bit % 8);
+            bit++;
+        }
+    }
+    return;
+}
\ No newline at end of file